@@ -14,20 +14,42 @@ var devrequire = function (opts) {
         var changed_modules = _.filter(_.values(modules), has_changed)
         return changed_modules        
     }    
+    // default exec : only changed modules and their dependents are loaded again (module.hot)
+    var incremental = !opts.exec && module.hot != undefined;
     function default_exec() {
-        self.purge_modules()        
+        if (!incremental) {
+            self.purge_modules()
+        }
         return require(target)()
     }
     var get_change = opts.get_change || default_get_change;
     var exec = opts.exec || default_exec;
     var should_notify = opts.notify || (self.JavascriptNotification != undefined);
     var notification_message = opts.message || "Hot reload(JS)"       
+    var discarded = false
+    
+    function reload() {
+        cleanup()
+        cleanup = exec()
+        if (!_.isFunction(cleanup)) {
+            cleanup = function () { }
+        }
+    }
     
     var cleanup = exec()
     if (!_.isFunction(cleanup)) {
         cleanup = function () { }
     }
     
+    if (incremental) {
+        // called by purge_modules when target has been invalidated
+        module.hot.accept(target, function () {
+            if (!discarded) {
+                reload()
+            }
+        })
+    }
+    
     /** aggregated watcher */
     var watcher = {
         list : [],
@@ -62,18 +84,20 @@ var devrequire = function (opts) {
         var changed_modules = get_change(watcher)
         var module_changed = changed_modules.length > 0
         if (module_changed) {
-            cleanup()            
-            cleanup = exec()
-            gc()
-            if (!_.isFunction(cleanup)) {
-                cleanup = function () { }
+            var started = Date.now()
+            if (incremental) {
+                self.purge_modules(changed_modules)
+            } else {
+                reload()
             }
+            var elapsed = Date.now() - started
+            gc()
 
             var file = _.unique(changed_modules).join(',')
 
             if (should_notify) {
                 var note = new JavascriptNotification
-                note.Text = notification_message + ": " + file
+                note.Text = notification_message + ": " + file + " (" + elapsed + "ms)"
                 note.bFireAndForget = true
                 note.Fire()
                 note.ExpireDuration = 3
@@ -87,6 +111,7 @@ var devrequire = function (opts) {
     });    
     
     return function () {
+        discarded = true
         watcher.Discard()
     }
 }
@@ -1,4 +1,7 @@
 (function (target) {
+    // timers are provided natively by V8 module
+    if (typeof target.setTimeout == 'function') return
+
     var makeWindowTimer = require('windowTimers')
     if (Root == undefined || Root.OnTick == undefined) return
     
@@ -13,6 +13,7 @@
 #include "EditorStyle.h"
 
 #include "JavascriptEditorModule.h"
+#include "JavascriptContext.h"
 
 #include "UMG.h"
 
@@ -9,42 +9,62 @@ ULandscapeInfo* UJavascriptEditorLibrary::GetLandscapeInfo(ALandscape* Landscape
 }
 
 void UJavascriptEditorLibrary::SetHeightmapDataFromMemory(ULandscapeInfo* LandscapeInfo, int32 MinX, int32 MinY, int32 MaxX, int32 MaxY)
+{
+	SetHeightmapDataFromBuffer(LandscapeInfo, MinX, MinY, MaxX, MaxY, FArrayBufferAccessor::GetBuffer());
+}
+
+void UJavascriptEditorLibrary::GetHeightmapDataToMemory(ULandscapeInfo* LandscapeInfo, int32 MinX, int32 MinY, int32 MaxX, int32 MaxY)
+{
+	GetHeightmapDataToBuffer(LandscapeInfo, MinX, MinY, MaxX, MaxY, FArrayBufferAccessor::GetBuffer());
+}
+
+void UJavascriptEditorLibrary::SetAlphamapDataFromMemory(ULandscapeInfo* LandscapeInfo, ULandscapeLayerInfoObject* LayerInfo, int32 MinX, int32 MinY, int32 MaxX, int32 MaxY, ELandscapeLayerPaintingRestriction::Type PaintingRestriction)
+{
+	SetAlphamapDataFromBuffer(LandscapeInfo, LayerInfo, MinX, MinY, MaxX, MaxY, FArrayBufferAccessor::GetBuffer(), PaintingRestriction);
+}
+
+void UJavascriptEditorLibrary::GetAlphamapDataToMemory(ULandscapeInfo* LandscapeInfo, ULandscapeLayerInfoObject* LayerInfo, int32 MinX, int32 MinY, int32 MaxX, int32 MaxY)
+{
+	GetAlphamapDataToBuffer(LandscapeInfo, LayerInfo, MinX, MinY, MaxX, MaxY, FArrayBufferAccessor::GetBuffer());
+}
+
+void UJavascriptEditorLibrary::SetHeightmapDataFromBuffer(ULandscapeInfo* LandscapeInfo, int32 MinX, int32 MinY, int32 MaxX, int32 MaxY, const FJavascriptBuffer& Buffer)
 {
 	const int32 SizeX = (1 + MaxX - MinX);
 	const int32 SizeY = (1 + MaxY - MinY);
 
-	if (SizeX * SizeY * 2 == FArrayBufferAccessor::GetSize())
+	if (SizeX * SizeY * 2 == Buffer.Size)
 	{
 		FHeightmapAccessor<false> Accessor(LandscapeInfo);
-		Accessor.SetData(MinX, MinY, MaxX, MaxY, (uint16*)FArrayBufferAccessor::GetData());
+		Accessor.SetData(MinX, MinY, MaxX, MaxY, (uint16*)Buffer.Data);
 	}	
 }
 
-void UJavascriptEditorLibrary::GetHeightmapDataToMemory(ULandscapeInfo* LandscapeInfo, int32 MinX, int32 MinY, int32 MaxX, int32 MaxY)
+void UJavascriptEditorLibrary::GetHeightmapDataToBuffer(ULandscapeInfo* LandscapeInfo, int32 MinX, int32 MinY, int32 MaxX, int32 MaxY, const FJavascriptBuffer& Buffer)
 {
 	const int32 SizeX = (1 + MaxX - MinX);
 	const int32 SizeY = (1 + MaxY - MinY);
 
-	if (SizeX * SizeY * 2 == FArrayBufferAccessor::GetSize())
+	if (SizeX * SizeY * 2 == Buffer.Size)
 	{
-		auto Buffer = (uint16*)FArrayBufferAccessor::GetData();
+		auto Dest = (uint16*)Buffer.Data;
 
 		FHeightmapAccessor<false> Accessor(LandscapeInfo);
 
 		TMap<FIntPoint, uint16> Data;
 		Accessor.GetData(MinX, MinY, MaxX, MaxY, Data);
 
-		FMemory::Memzero(Buffer, SizeX * SizeY * 2);
+		FMemory::Memzero(Dest, SizeX * SizeY * 2);
 
 		for (auto it = Data.CreateConstIterator(); it; ++it)
 		{
 			const auto& Point = it.Key();
-			Buffer[Point.X + Point.Y * SizeX] = it.Value();
+			Dest[Point.X + Point.Y * SizeX] = it.Value();
 		}
 	}
 }
 
-void UJavascriptEditorLibrary::SetAlphamapDataFromMemory(ULandscapeInfo* LandscapeInfo, ULandscapeLayerInfoObject* LayerInfo, int32 MinX, int32 MinY, int32 MaxX, int32 MaxY, ELandscapeLayerPaintingRestriction::Type PaintingRestriction)
+void UJavascriptEditorLibrary::SetAlphamapDataFromBuffer(ULandscapeInfo* LandscapeInfo, ULandscapeLayerInfoObject* LayerInfo, int32 MinX, int32 MinY, int32 MaxX, int32 MaxY, const FJavascriptBuffer& Buffer, ELandscapeLayerPaintingRestriction::Type PaintingRestriction)
 {
 	if (LayerInfo == nullptr)
 	{
@@ -54,14 +74,14 @@ void UJavascriptEditorLibrary::SetAlphamapDataFromMemory(ULandscapeInfo* Landsca
 	const int32 SizeX = (1 + MaxX - MinX);
 	const int32 SizeY = (1 + MaxY - MinY);
 
-	if (SizeX * SizeY * 1 == FArrayBufferAccessor::GetSize())
+	if (SizeX * SizeY * 1 == Buffer.Size)
 	{
 		FAlphamapAccessor<false,false> Accessor(LandscapeInfo, LayerInfo);
-		Accessor.SetData(MinX, MinY, MaxX, MaxY, (uint8*)FArrayBufferAccessor::GetData(), PaintingRestriction);
+		Accessor.SetData(MinX, MinY, MaxX, MaxY, (uint8*)Buffer.Data, PaintingRestriction);
 	}
 }
 
-void UJavascriptEditorLibrary::GetAlphamapDataToMemory(ULandscapeInfo* LandscapeInfo, ULandscapeLayerInfoObject* LayerInfo, int32 MinX, int32 MinY, int32 MaxX, int32 MaxY)
+void UJavascriptEditorLibrary::GetAlphamapDataToBuffer(ULandscapeInfo* LandscapeInfo, ULandscapeLayerInfoObject* LayerInfo, int32 MinX, int32 MinY, int32 MaxX, int32 MaxY, const FJavascriptBuffer& Buffer)
 {
 	if (LayerInfo == nullptr)
 	{
@@ -71,21 +91,21 @@ void UJavascriptEditorLibrary::GetAlphamapDataToMemory(ULandscapeInfo* Landscape
 	const int32 SizeX = (1 + MaxX - MinX);
 	const int32 SizeY = (1 + MaxY - MinY);
 
-	if (SizeX * SizeY * 1 == FArrayBufferAccessor::GetSize())
+	if (SizeX * SizeY * 1 == Buffer.Size)
 	{
-		auto Buffer = (uint8*)FArrayBufferAccessor::GetData();
+		auto Dest = (uint8*)Buffer.Data;
 
 		FAlphamapAccessor<false, false> Accessor(LandscapeInfo, LayerInfo);
 
 		TMap<FIntPoint, uint8> Data;
 		Accessor.GetData(MinX, MinY, MaxX, MaxY, Data);
 
-		FMemory::Memzero(Buffer, SizeX * SizeY);
+		FMemory::Memzero(Dest, SizeX * SizeY);
 
 		for (auto it = Data.CreateConstIterator(); it; ++it)
 		{
 			const auto& Point = it.Key();
-			Buffer[Point.X + Point.Y * SizeX] = it.Value();
+			Dest[Point.X + Point.Y * SizeX] = it.Value();
 		}
 	}
 }
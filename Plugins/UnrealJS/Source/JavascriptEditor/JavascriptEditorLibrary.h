@@ -26,6 +26,20 @@ class JAVASCRIPTEDITOR_API UJavascriptEditorLibrary : public UBlueprintFunctionL
 	UFUNCTION(BlueprintCallable, Category = "Javascript | Editor")
 	static void GetAlphamapDataToMemory(ULandscapeInfo* LandscapeInfo, ULandscapeLayerInfoObject* LayerInfo, int32 MinX, int32 MinY, int32 MaxX, int32 MaxY);
 
+	/** Buffer holds (1 + MaxX - MinX) * (1 + MaxY - MinY) uint16 heights */
+	UFUNCTION(BlueprintCallable, Category = "Javascript | Editor")
+	static void SetHeightmapDataFromBuffer(ULandscapeInfo* LandscapeInfo, int32 MinX, int32 MinY, int32 MaxX, int32 MaxY, const FJavascriptBuffer& Buffer);
+
+	UFUNCTION(BlueprintCallable, Category = "Javascript | Editor")
+	static void GetHeightmapDataToBuffer(ULandscapeInfo* LandscapeInfo, int32 MinX, int32 MinY, int32 MaxX, int32 MaxY, const FJavascriptBuffer& Buffer);
+
+	/** Buffer holds (1 + MaxX - MinX) * (1 + MaxY - MinY) uint8 weights */
+	UFUNCTION(BlueprintCallable, Category = "Javascript | Editor")
+	static void SetAlphamapDataFromBuffer(ULandscapeInfo* LandscapeInfo, ULandscapeLayerInfoObject* LayerInfo, int32 MinX, int32 MinY, int32 MaxX, int32 MaxY, const FJavascriptBuffer& Buffer, ELandscapeLayerPaintingRestriction::Type PaintingRestriction = ELandscapeLayerPaintingRestriction::None);
+
+	UFUNCTION(BlueprintCallable, Category = "Javascript | Editor")
+	static void GetAlphamapDataToBuffer(ULandscapeInfo* LandscapeInfo, ULandscapeLayerInfoObject* LayerInfo, int32 MinX, int32 MinY, int32 MaxX, int32 MaxY, const FJavascriptBuffer& Buffer);
+
 	UFUNCTION(BlueprintCallable, Category = "Javascript | Editor")
 	static ULandscapeLayerInfoObject* GetLayerInfoByName(ULandscapeInfo* LandscapeInfo, FName LayerName, ALandscapeProxy* Owner = NULL);
 
@@ -7,5 +7,7 @@
 #include "IHttpResponse.h"
 #include "HttpModule.h"
 
+#include "JavascriptContext.h"
+
 // Interfaces
 #include "IJavascriptHttpModule.h"
@@ -83,9 +83,14 @@ void UJavascriptHttpRequest::SetURL(const FString& URL)
 }
 
 void UJavascriptHttpRequest::SetContentFromMemory()
+{
+	SetContentFromBuffer(FArrayBufferAccessor::GetBuffer());
+}
+
+void UJavascriptHttpRequest::SetContentFromBuffer(const FJavascriptBuffer& Buffer)
 {
 	TArray<uint8> Payload;
-	Payload.Append((uint8*)FArrayBufferAccessor::GetData(), FArrayBufferAccessor::GetSize());
+	Payload.Append((uint8*)Buffer.Data, Buffer.Size);
 	Request->SetContent(Payload);
 }
 
@@ -159,16 +164,24 @@ int32 UJavascriptHttpRequest::GetContentLength()
 }
 
 void UJavascriptHttpRequest::GetContentToMemory()
+{
+	GetContentToBuffer(FArrayBufferAccessor::GetBuffer());
+}
+
+int32 UJavascriptHttpRequest::GetContentToBuffer(const FJavascriptBuffer& Buffer)
 {
 	auto res = Request->GetResponse();
-	if (!res.IsValid()) return;
+	if (!res.IsValid()) return 0;
 
-	const auto& Content = Request->GetResponse()->GetContent();
+	const auto& Content = res->GetContent();
 
-	if (FArrayBufferAccessor::GetSize() >= Content.Num())
+	if (Buffer.Size >= Content.Num())
 	{
-		FMemory::Memcpy(FArrayBufferAccessor::GetData(), Content.GetData(), Content.Num());
+		FMemory::Memcpy(Buffer.Data, Content.GetData(), Content.Num());
+		return Content.Num();
 	}
+
+	return 0;
 }
 
 float UJavascriptHttpRequest::GetElapsedTime()
@@ -72,6 +72,14 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Online | Http")
 	void SetContentFromMemory();
 
+	/**
+	* Sets the content of the request from an ArrayBuffer or typed array.
+	*
+	* @param Buffer - payload to set.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Online | Http")
+	void SetContentFromBuffer(const FJavascriptBuffer& Buffer);
+
 	/**
 	* Sets the content of the request as a string encoded as UTF8.
 	*
@@ -160,6 +168,10 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Online | Http")
 	void GetContentToMemory();
 
+	/** Copies the response content into an ArrayBuffer or typed array, returns the number of bytes copied (0 if it doesn't fit) */
+	UFUNCTION(BlueprintCallable, Category = "Online | Http")
+	int32 GetContentToBuffer(const FJavascriptBuffer& Buffer);
+
 	/**
 	* Gets the time that it took for the server to fully respond to the request.
 	*
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "ScriptBundle.h"
+
+/** Wraps module source into a function of (__dirname, __filename, require, module), which takes two lines */
+inline FString WrapModuleSource(const FString& Text)
+{
+	return FString::Printf(TEXT("(function (__dirname, __filename, require, module) {\nvar exports = module.exports;\n%s\n;return module.exports;})"), *Text);
+}
+
+/** Hands the whole script to V8 parser in a single chunk, it has been read already on the same worker thread */
+class FScriptSourceStream : public v8::ScriptCompiler::ExternalSourceStream
+{
+public:
+	TArray<uint8> Data;
+
+	virtual size_t GetMoreData(const uint8_t** src) override
+	{
+		if (bConsumed || Data.Num() == 0) return 0;
+
+		bConsumed = true;
+
+		// V8 takes ownership
+		auto Chunk = new uint8_t[Data.Num()];
+		FMemory::Memcpy(Chunk, Data.GetData(), Data.Num());
+		*src = Chunk;
+		return Data.Num();
+	}
+
+private:
+	bool bConsumed{ false };
+};
+
+struct FAsyncScriptLoad;
+
+/** Reads a script, and parses it when V8 can stream it, on the thread pool */
+class FScriptLoadTask : public FNonAbandonableTask
+{
+public:
+	FScriptLoadTask(FAsyncScriptLoad* InLoad)
+		: Load(InLoad)
+	{}
+
+	void DoWork();
+
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(FScriptLoadTask, STATGROUP_ThreadPoolAsyncTasks);
+	}
+
+private:
+	FAsyncScriptLoad* Load;
+};
+
+/** A script being loaded by RunFileAsync/requireAsync, finished on the game thread */
+struct FAsyncScriptLoad
+{
+	enum class EKind
+	{
+		File,
+		Module
+	};
+
+	EKind Kind;
+
+	// Full path to read
+	FString Filename;
+
+	// Read by the worker, wrapped already for modules
+	FString Text;
+	bool bLoaded{ false };
+
+	// Null when V8 can't stream the script, it is compiled on the game thread as usual then
+	v8::ScriptCompiler::StreamedSource* Source{ nullptr };
+	v8::ScriptCompiler::ScriptStreamingTask* StreamingTask{ nullptr };
+	FScriptSourceStream* Stream{ nullptr };
+
+	FAsyncTask<FScriptLoadTask>* Task{ nullptr };
+
+	// Settled when done, shared by everyone waiting for the same script
+	v8::UniquePersistent<v8::Promise::Resolver> Resolver;
+
+	~FAsyncScriptLoad()
+	{
+		if (Task)
+		{
+			Task->EnsureCompletion();
+			delete Task;
+		}
+
+		delete StreamingTask;
+		delete Source;
+	}
+};
+
+inline void FScriptLoadTask::DoWork()
+{
+	Load->bLoaded = FJavascriptScriptBundle::LoadFileToString(Load->Text, Load->Filename);
+
+	if (Load->bLoaded && Load->Kind == FAsyncScriptLoad::EKind::Module)
+	{
+		Load->Text = WrapModuleSource(Load->Text);
+	}
+
+	if (Load->StreamingTask)
+	{
+		if (Load->bLoaded)
+		{
+			FTCHARToUTF8 Utf8(*Load->Text);
+			Load->Stream->Data.Append((const uint8*)Utf8.Get(), Utf8.Length());
+		}
+
+		// Without data, parsing just fails and the script isn't compiled from the stream
+		Load->StreamingTask->Run();
+	}
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+/**
+ * Flattened parameter layout of a UFunction which is called from Javascript.
+ * Built once per function and isolate, so that CallFunction doesn't need to iterate over properties for each call.
+ */
+struct FJavascriptCallPlan
+{
+	typedef void(*FWriteParam)(v8::Isolate* isolate, UProperty* Property, uint8* Buffer, int32 Offset, v8::Local<v8::Value> Value);
+	typedef v8::Local<v8::Value>(*FReadParam)(v8::Isolate* isolate, UProperty* Property, uint8* Buffer, int32 Offset);
+
+	struct FInputParam
+	{
+		UProperty* Property;
+		int32 Offset;
+		FWriteParam Write;
+	};
+
+	struct FOutputParam
+	{
+		UProperty* Property;
+		int32 Offset;
+		FReadParam Read;
+		// Parameter name or "$" for return value
+		v8::UniquePersistent<v8::String> Name;
+	};
+
+	// To detect stale plans (functions can be recreated by hot reload or Javascript generated classes)
+	TWeakObjectPtr<UFunction> Function;
+
+	int32 ParmsSize;
+
+	// All parameters including return value, which need to be constructed and destructed
+	TArray<UProperty*> Params;
+
+	// Input parameters in declaration order
+	TArray<FInputParam> InputParams;
+
+	// 'T&' parameters (and return value) to pass back within an object
+	TArray<FOutputParam> OutParams;
+
+	// Return value (-1 if none)
+	int32 ReturnParamIndex;
+
+	bool bHasAnyOutParams;
+
+	// Parameter block can be zero-initialized and needs no destruction
+	bool bPOD;
+
+	FJavascriptCallPlan(v8::Isolate* isolate, UFunction* InFunction)
+		: Function(InFunction), ParmsSize(InFunction->ParmsSize), ReturnParamIndex(-1), bHasAnyOutParams(false), bPOD(true)
+	{
+		for (TFieldIterator<UProperty> It(InFunction); It && (It->PropertyFlags & CPF_Parm) == CPF_Parm; ++It)
+		{
+			auto Prop = *It;
+
+			Params.Add(Prop);
+
+			if (!Prop->HasAllPropertyFlags(CPF_ZeroConstructor) || !Prop->HasAnyPropertyFlags(CPF_NoDestructor | CPF_IsPlainOldData))
+			{
+				bPOD = false;
+			}
+
+			if (Prop->PropertyFlags & CPF_ReturnParm)
+			{
+				continue;
+			}
+
+			FInputParam Input = { Prop, Prop->GetOffset_ForUFunction(), GetWriter(Prop) };
+			InputParams.Add(Input);
+
+			// This is 'out ref'!
+			if ((Prop->PropertyFlags & (CPF_ConstParm | CPF_OutParm)) == CPF_OutParm)
+			{
+				bHasAnyOutParams = true;
+			}
+		}
+
+		for (auto Prop : Params)
+		{
+			auto PropertyFlags = Prop->GetPropertyFlags();
+
+			// pass return parameter as '$', rejects 'const T&' and pass 'T&' as its name
+			if ((PropertyFlags & CPF_ReturnParm) || (PropertyFlags & (CPF_ConstParm | CPF_OutParm)) == CPF_OutParm)
+			{
+				if (PropertyFlags & CPF_ReturnParm)
+				{
+					ReturnParamIndex = OutParams.Num();
+				}
+
+				auto Index = OutParams.AddDefaulted();
+				auto& Output = OutParams[Index];
+				Output.Property = Prop;
+				Output.Offset = Prop->GetOffset_ForUFunction();
+				Output.Read = GetReader(Prop);
+				Output.Name.Reset(isolate, (PropertyFlags & CPF_ReturnParm) ? V8_KeywordString(isolate, "$") : V8_KeywordString(isolate, Prop->GetFName()));
+			}
+		}
+	}
+
+	bool IsValidFor(UFunction* InFunction) const
+	{
+		return Function.Get() == InFunction && ParmsSize == InFunction->ParmsSize;
+	}
+
+	void InitializeParams(uint8* Buffer) const
+	{
+		if (bPOD)
+		{
+			FMemory::Memzero(Buffer, ParmsSize);
+		}
+		else
+		{
+			for (auto Prop : Params)
+			{
+				Prop->InitializeValue_InContainer(Buffer);
+			}
+		}
+	}
+
+	void DestroyParams(uint8* Buffer) const
+	{
+		if (!bPOD)
+		{
+			for (auto Prop : Params)
+			{
+				Prop->DestroyValue_InContainer(Buffer);
+			}
+		}
+	}
+
+private:
+	static FWriteParam GetWriter(UProperty* Property)
+	{
+		if (Property->IsA<UIntProperty>())
+		{
+			return [](v8::Isolate*, UProperty* Property, uint8* Buffer, int32 Offset, v8::Local<v8::Value> Value) {
+				*(int32*)(Buffer + Offset) = Value->Int32Value();
+			};
+		}
+		else if (Property->IsA<UFloatProperty>())
+		{
+			return [](v8::Isolate*, UProperty* Property, uint8* Buffer, int32 Offset, v8::Local<v8::Value> Value) {
+				*(float*)(Buffer + Offset) = Value->NumberValue();
+			};
+		}
+		else if (Property->IsA<UBoolProperty>())
+		{
+			return [](v8::Isolate*, UProperty* Property, uint8* Buffer, int32 Offset, v8::Local<v8::Value> Value) {
+				static_cast<UBoolProperty*>(Property)->SetPropertyValue_InContainer(Buffer, Value->BooleanValue());
+			};
+		}
+		else
+		{
+			return [](v8::Isolate* isolate, UProperty* Property, uint8* Buffer, int32 Offset, v8::Local<v8::Value> Value) {
+				v8::WriteProperty(isolate, Property, Buffer, Value);
+			};
+		}
+	}
+
+	static FReadParam GetReader(UProperty* Property)
+	{
+		if (Property->IsA<UIntProperty>())
+		{
+			return [](v8::Isolate* isolate, UProperty* Property, uint8* Buffer, int32 Offset) -> v8::Local<v8::Value> {
+				return v8::Int32::New(isolate, *(int32*)(Buffer + Offset));
+			};
+		}
+		else if (Property->IsA<UFloatProperty>())
+		{
+			return [](v8::Isolate* isolate, UProperty* Property, uint8* Buffer, int32 Offset) -> v8::Local<v8::Value> {
+				return v8::Number::New(isolate, *(float*)(Buffer + Offset));
+			};
+		}
+		else if (Property->IsA<UBoolProperty>())
+		{
+			return [](v8::Isolate* isolate, UProperty* Property, uint8* Buffer, int32 Offset) -> v8::Local<v8::Value> {
+				return v8::Boolean::New(isolate, static_cast<UBoolProperty*>(Property)->GetPropertyValue_InContainer(Buffer));
+			};
+		}
+		else
+		{
+			return [](v8::Isolate* isolate, UProperty* Property, uint8* Buffer, int32 Offset) -> v8::Local<v8::Value> {
+				return v8::ReadProperty(isolate, Property, Buffer, FNoPropertyOwner());
+			};
+		}
+	}
+};
@@ -0,0 +1,156 @@
+#include "V8PCH.h"
+#include "CodeCache.h"
+#include "JavascriptSettings.h"
+#include "ScriptBundle.h"
+
+using namespace v8;
+
+DECLARE_CYCLE_STAT(TEXT("Compile script"), STAT_JavascriptCompileScript, STATGROUP_Javascript);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Code cache hits"), STAT_JavascriptCodeCacheHits, STATGROUP_Javascript);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Code cache misses"), STAT_JavascriptCodeCacheMisses, STATGROUP_Javascript);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Code cache rejects"), STAT_JavascriptCodeCacheRejects, STATGROUP_Javascript);
+
+int32 FJavascriptCodeCache::NumHits = 0;
+int32 FJavascriptCodeCache::NumMisses = 0;
+int32 FJavascriptCodeCache::NumRejects = 0;
+
+static const uint32 CodeCacheMagicNumber = 0x4a534343;
+
+FString FJavascriptCodeCache::GetContentHash(const FString& String)
+{
+	uint8 Digest[16];
+
+	FMD5 Md5;
+	Md5.Update((const uint8*)*String, String.Len() * sizeof(TCHAR));
+	Md5.Final(Digest);
+
+	return BytesToHex(Digest, sizeof(Digest));
+}
+
+namespace
+{
+	FString GetCacheFilename(const FString& Filename)
+	{
+		return FPaths::GameSavedDir() / TEXT("Javascript/CodeCache") / FJavascriptCodeCache::GetContentHash(FPaths::ConvertRelativePathToFull(Filename)) + TEXT(".bin");
+	}
+
+	bool LoadCachedData(const FString& CacheFilename, const FString& ContentHash, TArray<uint8>& OutData)
+	{
+		TScopedPointer<FArchive> Ar(IFileManager::Get().CreateFileReader(*CacheFilename));
+		if (!Ar.IsValid()) return false;
+
+		uint32 Magic = 0, VersionTag = 0;
+		FString Hash;
+		*Ar << Magic;
+		*Ar << VersionTag;
+		*Ar << Hash;
+
+		// V8 version/flags or script content has been changed
+		if (Magic != CodeCacheMagicNumber || VersionTag != ScriptCompiler::CachedDataVersionTag() || Hash != ContentHash)
+		{
+			return false;
+		}
+
+		*Ar << OutData;
+		return OutData.Num() > 0;
+	}
+
+	void SaveCachedData(const FString& CacheFilename, const FString& ContentHash, const ScriptCompiler::CachedData* Data)
+	{
+		if (!Data || !Data->data || Data->length == 0) return;
+
+		TScopedPointer<FArchive> Ar(IFileManager::Get().CreateFileWriter(*CacheFilename));
+		if (!Ar.IsValid()) return;
+
+		uint32 Magic = CodeCacheMagicNumber, VersionTag = ScriptCompiler::CachedDataVersionTag();
+		FString Hash = ContentHash;
+		TArray<uint8> Buffer;
+		Buffer.Append(Data->data, Data->length);
+
+		*Ar << Magic;
+		*Ar << VersionTag;
+		*Ar << Hash;
+		*Ar << Buffer;
+	}
+}
+
+bool FJavascriptCodeCache::IsEnabled()
+{
+	return GetDefault<UJavascriptSettings>()->bCodeCache;
+}
+
+MaybeLocal<Script> FJavascriptCodeCache::Compile(Local<Context> context, const FString& Filename, const FString& Text, Local<String> source, const ScriptOrigin& origin)
+{
+	SCOPE_CYCLE_COUNTER(STAT_JavascriptCompileScript);
+
+	if (!IsEnabled())
+	{
+		ScriptCompiler::Source script_source(source, origin);
+		return ScriptCompiler::Compile(context, &script_source);
+	}
+
+	auto ContentHash = GetContentHash(Text);
+
+	// Packed by JavascriptBundle commandlet, used in place.
+	// A rejected entry has been compiled in full already, and the bundle can't be rebuilt here : just use the result.
+	const uint8* BundledData = nullptr;
+	int32 BundledLength = 0;
+	if (FJavascriptScriptBundle::FindCodeCache(ContentHash, BundledData, BundledLength))
+	{
+		ScriptCompiler::Source script_source(source, origin, new ScriptCompiler::CachedData(BundledData, BundledLength));
+		auto script = ScriptCompiler::Compile(context, &script_source, ScriptCompiler::kConsumeCodeCache);
+
+		if (!script_source.GetCachedData()->rejected)
+		{
+			++NumHits;
+			INC_DWORD_STAT(STAT_JavascriptCodeCacheHits);
+		}
+		else
+		{
+			++NumRejects;
+			INC_DWORD_STAT(STAT_JavascriptCodeCacheRejects);
+			UE_LOG(Javascript, Verbose, TEXT("Bundled code cache rejected, rebuild the bundle : %s"), *Filename);
+		}
+
+		return script;
+	}
+
+	auto CacheFilename = GetCacheFilename(Filename);
+
+	TArray<uint8> Data;
+	if (LoadCachedData(CacheFilename, ContentHash, Data))
+	{
+		// Source takes ownership of CachedData, but not of the buffer.
+		ScriptCompiler::Source script_source(source, origin, new ScriptCompiler::CachedData(Data.GetData(), Data.Num()));
+		auto script = ScriptCompiler::Compile(context, &script_source, ScriptCompiler::kConsumeCodeCache);
+
+		if (!script_source.GetCachedData()->rejected)
+		{
+			++NumHits;
+			INC_DWORD_STAT(STAT_JavascriptCodeCacheHits);
+			return script;
+		}
+
+		// V8 has fallen back to a full compile already. This V8 can't produce cache out of a compiled script,
+		// so drop the stale entry instead of compiling again : the next load takes the miss path below.
+		++NumRejects;
+		INC_DWORD_STAT(STAT_JavascriptCodeCacheRejects);
+		UE_LOG(Javascript, Verbose, TEXT("Code cache rejected : %s"), *Filename);
+
+		IFileManager::Get().Delete(*CacheFilename, false, false, true);
+		return script;
+	}
+
+	++NumMisses;
+	INC_DWORD_STAT(STAT_JavascriptCodeCacheMisses);
+
+	// Build cached data
+	ScriptCompiler::Source script_source(source, origin);
+	auto script = ScriptCompiler::Compile(context, &script_source, ScriptCompiler::kProduceCodeCache);
+	if (!script.IsEmpty())
+	{
+		SaveCachedData(CacheFilename, ContentHash, script_source.GetCachedData());
+	}
+
+	return script;
+}
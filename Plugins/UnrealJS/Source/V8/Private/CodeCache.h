@@ -0,0 +1,22 @@
+#pragma once
+
+/**
+ * Persistent code cache for scripts loaded from file (require, RunFile)
+ * Cached data lives under Saved/Javascript/CodeCache, one file per script path, or within the script bundle (see FJavascriptScriptBundle).
+ * Each entry is tagged with content hash of the script and V8 version/flags, so stale entries are detected and rebuilt.
+ */
+struct FJavascriptCodeCache
+{
+	static bool IsEnabled();
+
+	/** Compiles the script, consuming cached data if valid, producing one otherwise */
+	static v8::MaybeLocal<v8::Script> Compile(v8::Local<v8::Context> context, const FString& Filename, const FString& Text, v8::Local<v8::String> source, const v8::ScriptOrigin& origin);
+
+	/** Tags cached data with the script it has been built from */
+	static FString GetContentHash(const FString& Text);
+
+	/** Cache hit/miss/reject counters since startup */
+	static int32 NumHits;
+	static int32 NumMisses;
+	static int32 NumRejects;
+};
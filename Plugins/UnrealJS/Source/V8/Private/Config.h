@@ -38,6 +38,43 @@ struct FV8Config
 		}
 	}
 
+	// Inverse of Safeify : exported name -> UObject name
+	static FString Unsafeify(const FString& Name)
+	{
+		if (Name == "UObject")
+		{
+			return TEXT("Object");
+		}
+		else if (Name == "UNode")
+		{
+			return TEXT("Node");
+		}
+		else if (Name == "UFunction")
+		{
+			return TEXT("Function");
+		}
+		else if (Name == "UPointerEvent")
+		{
+			return TEXT("PointerEvent");
+		}
+		else if (Name == "UImage")
+		{
+			return TEXT("Image");
+		}
+		else if (Name == "USelection")
+		{
+			return TEXT("Selection");
+		}
+		else if (Name == "UFocusEvent")
+		{
+			return TEXT("FocusEvent");
+		}
+		else
+		{
+			return Name;
+		}
+	}
+
 	// 
 	static bool CanExportClass(const UClass* Class)
 	{
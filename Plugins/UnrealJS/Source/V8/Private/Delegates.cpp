@@ -1,21 +1,63 @@
 #include "V8PCH.h"
 #include "JavascriptDelegate.h"
 #include "Translator.h"
+#include "Exception.h"
 #include "Delegates.h"
+#include "JavascriptSettings.h"
+#include "JavascriptIsolate.h"
+#include "JavascriptContext.h"
+#include "DirectoryWatcher.h"
+#include "TypedArrays.h"
 
 using namespace v8;
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Delegates"), STAT_JavascriptDelegates, STATGROUP_Javascript);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Swept delegates"), STAT_JavascriptSweptDelegates, STATGROUP_Javascript);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Batched delegate events"), STAT_JavascriptBatchedDelegateEvents, STATGROUP_Javascript);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Delegate transitions saved"), STAT_JavascriptDelegateTransitionsSaved, STATGROUP_Javascript);
+
+/**
+ * Javascript listeners of a delegate property.
+ *
+ * The delegate is bound to a single dispatcher object (UJavascriptDelegate) which calls listeners in order,
+ * so adding or removing a listener doesn't create any UObject.
+ *
+ * In batched mode (proxy.Batch(true)) fired events are copied into an arena and delivered once per frame
+ * (or batching window) to each listener as a single array of { param: value } objects.
+ * Delegates with out parameters, return values or object references nested in struct/array parameters can't be batched.
+ */
 class FJavascriptDelegate
 {
 public:
 	FWeakObjectPtr WeakObject;
 	UProperty* Property;
 	Persistent<Context> context_;
+	// Listener id -> function
 	TMap<int32, UniquePersistent<Function>> functions;
+	// Listener ids in the order of Add
+	TArray<int32> Listeners;
+	// Identity hash of function -> listener id (hashes may collide, so candidates are compared with StrictEquals)
+	TMultiMap<int32, int32> ListenersByHash;
 	Persistent<Object> WrappedObject;
 	Isolate* isolate_;
 	int32 NextUniqueId{ 0 };
 	bool bAbandoned{ false };
+	// Set when Javascript doesn't reference the proxy any more, an abandoned delegate can be deleted then
+	bool bWrapperCollected{ false };
+
+	// Bound to the delegate while there are listeners, kept alive by FDelegateManager::AddReferencedObjects
+	UJavascriptDelegate* Dispatcher{ nullptr };
+
+	// Batched mode
+	bool bBatched{ false };
+	double BatchWindow{ 0 };
+	int32 MaxBatchSize{ 0 };
+	double FirstBatchedTime{ 0 };
+	int32 BatchStride{ 0 };
+	int32 NumBatched{ 0 };
+	TArray<uint8> BatchArena;
+	// Manager's list of delegates in batched mode
+	TSet<FJavascriptDelegate*>* BatchedDelegates{ nullptr };
 
 	bool IsValid() const
 	{
@@ -29,22 +71,36 @@ public:
 	~FJavascriptDelegate()
 	{
 		Purge();
+
+		WrappedObject.Reset();
 	}
 
+	// Releases all listeners, the proxy stays usable (as a no-op) until it is collected
 	void Purge()
 	{
 		if (!bAbandoned)
 		{
 			bAbandoned = true;
 
-			WrappedObject.Reset();
+			// Queued events are dropped, the listeners may be gone already
+			if (bBatched)
+			{
+				DestroyBatch();
+				bBatched = false;
+				BatchedDelegates->Remove(this);
+			}
 
-			ClearDelegateObjects();
+			ClearListeners();
 
 			context_.Reset();
 		}
 	}
 
+	bool CanBeDeleted() const
+	{
+		return bAbandoned && bWrapperCollected;
+	}
+
 	Local<Object> Initialize(Local<Context> context)
 	{
 		isolate_ = context->GetIsolate();
@@ -56,7 +112,7 @@ public:
 			for (;;)
 			{
 				auto payload = reinterpret_cast<FJavascriptDelegate*>(Local<External>::Cast(info.Data())->Value());
-				if (info.Length() == 1)
+				if (info.Length() == 1 && info[0]->IsFunction())
 				{
 					auto func = Local<Function>::Cast(info[0]);
 					if (!func.IsEmpty())
@@ -75,7 +131,7 @@ public:
 			for (;;)
 			{
 				auto payload = reinterpret_cast<FJavascriptDelegate*>(Local<External>::Cast(info.Data())->Value());
-				if (info.Length() == 1)
+				if (info.Length() == 1 && info[0]->IsFunction())
 				{
 					auto func = Local<Function>::Cast(info[0]);
 					if (!func.IsEmpty())
@@ -99,12 +155,12 @@ public:
 			auto payload = reinterpret_cast<FJavascriptDelegate*>(Local<External>::Cast(info.Data())->Value());
 
 			uint32_t Index = 0;			
-			auto arr = Array::New(info.GetIsolate(), payload->DelegateObjects.Num());
+			auto arr = Array::New(info.GetIsolate(), payload->Listeners.Num());
 			const bool bIsMulticastDelegate = payload->Property->IsA(UMulticastDelegateProperty::StaticClass());
 
-			for (auto DelegateObject : payload->DelegateObjects)
+			for (auto Id : payload->Listeners)
 			{
-				auto JavascriptFunction = payload->functions.Find(DelegateObject->UniqueId);
+				auto JavascriptFunction = payload->functions.Find(Id);
 				if (JavascriptFunction)
 				{
 					auto function = Local<Function>::New(info.GetIsolate(), *JavascriptFunction);
@@ -128,68 +184,120 @@ public:
 			}			
 		};
 
+		// Batch(enable[, { window: milliseconds, max: events }])
+		auto batch = [](const FunctionCallbackInfo<Value>& info) {
+			auto payload = reinterpret_cast<FJavascriptDelegate*>(Local<External>::Cast(info.Data())->Value());
+			auto isolate = info.GetIsolate();
+			auto Settings = GetDefault<UJavascriptSettings>();
+
+			if (info.Length() == 0 || info[0]->BooleanValue())
+			{
+				double Window = Settings->DelegateBatchWindowMs;
+				int32 MaxEvents = Settings->DelegateBatchMaxQueue;
+
+				if (info.Length() > 1 && info[1]->IsObject())
+				{
+					auto Options = info[1]->ToObject();
+					auto window = Options->Get(V8_KeywordString(isolate, "window"));
+					auto max = Options->Get(V8_KeywordString(isolate, "max"));
+					if (window->IsNumber()) Window = window->NumberValue();
+					if (max->IsNumber()) MaxEvents = max->Int32Value();
+				}
+
+				payload->EnableBatching(Window / 1000, MaxEvents);
+			}
+			else
+			{
+				payload->DisableBatching();
+			}
+		};
+
 		auto data = External::New(isolate_, this);
 
+		out->Set(V8_KeywordString(isolate_, "Batch"), Function::New(isolate_, batch, data));
 		out->Set(V8_KeywordString(isolate_, "Add"), Function::New(isolate_, add, data));
 		out->Set(V8_KeywordString(isolate_, "Remove"), Function::New(isolate_, remove, data));
 		out->Set(V8_KeywordString(isolate_, "Clear"), Function::New(isolate_, clear, data));
 		out->Set(V8_KeywordString(isolate_, "toJSON"), Function::New(isolate_, toJSON, data));
 
 		WrappedObject.Reset(isolate_, out);
+		WrappedObject.SetWeak(this, [](const WeakCallbackData<Object, FJavascriptDelegate>& data) {
+			auto payload = data.GetParameter();
+			payload->WrappedObject.Reset();
+			payload->bWrapperCollected = true;
+		});
 
 		return out;
 	}
 
-	TArray<UJavascriptDelegate*> DelegateObjects;
-
-	void ClearDelegateObjects()
+	void ClearListeners()
 	{
-		for (auto obj : DelegateObjects)
+		if (Listeners.Num())
+		{
+			UnbindDispatcher();
+		}
+
+		if (Dispatcher)
 		{
-			obj->RemoveFromRoot();
+			Dispatcher->JavascriptDelegate = nullptr;
+			Dispatcher = nullptr;
 		}
-		DelegateObjects.Empty();
+		Listeners.Empty();
 		functions.Empty();
+		ListenersByHash.Empty();
 	}
 
 	void Add(Local<Function> function)
 	{
-		auto DelegateObject = NewObject<UJavascriptDelegate>();
+		if (bAbandoned) return;
 
-		DelegateObject->UniqueId = NextUniqueId++;
+		// Single-cast delegate holds only one listener
+		if (!Property->IsA(UMulticastDelegateProperty::StaticClass()))
+		{
+			Clear();
+		}
 
-		Bind(DelegateObject, function);
+		if (Listeners.Num() == 0)
+		{
+			BindDispatcher();
+		}
+
+		auto Id = NextUniqueId++;
+		Listeners.Add(Id);
+		functions.Add(Id, UniquePersistent<Function>(isolate_, function));
+		ListenersByHash.Add(function->GetIdentityHash(), Id);
 	}
 
-	UJavascriptDelegate* FindJavascriptDelegateByFunction(Local<Function> function)
+	int32 FindListenerByFunction(Local<Function> function)
 	{
 		HandleScope handle_scope(isolate_);
 
-		bool bWasSuccessful = false;
-		for (auto it = functions.CreateIterator(); it; ++it)
+		for (auto it = ListenersByHash.CreateKeyIterator(function->GetIdentityHash()); it; ++it)
 		{
-			if (Local<Function>::New(isolate_, it.Value())->Equals(function))
+			auto stored = functions.Find(it.Value());
+			if (stored && Local<Function>::New(isolate_, *stored)->StrictEquals(function))
 			{
-				for (auto obj : DelegateObjects)
-				{
-					if (obj->UniqueId == it.Key())
-					{
-						return obj;
-					}
-				}
+				return it.Value();
 			}
 		}
 
-		return nullptr;
+		return INDEX_NONE;
 	}
 
 	void Remove(Local<Function> function)
 	{
-		auto obj = FindJavascriptDelegateByFunction(function);
+		auto Id = FindListenerByFunction(function);
 
-		if (obj)
+		if (Id != INDEX_NONE)
 		{
-			Unbind(obj);
+			ListenersByHash.RemoveSingle(function->GetIdentityHash(), Id);
+			functions.Remove(Id);
+			Listeners.Remove(Id);
+
+			if (Listeners.Num() == 0)
+			{
+				UnbindDispatcher();
+			}
 		}
 		else
 		{
@@ -199,50 +307,54 @@ public:
 
 	void Clear()
 	{
-		while (DelegateObjects.Num())
+		if (Listeners.Num())
 		{
-			Unbind(DelegateObjects[0]);
+			UnbindDispatcher();
 		}
+
+		Listeners.Empty();
+		functions.Empty();
+		ListenersByHash.Empty();
 	}
 
-	void Bind(UJavascriptDelegate* DelegateObject, Local<Function> function)
+	void BindDispatcher()
 	{
 		static FName NAME_Fire("Fire");
 
+		if (!Dispatcher)
+		{
+			Dispatcher = NewObject<UJavascriptDelegate>();
+			Dispatcher->JavascriptDelegate = this;
+		}
+
 		if (WeakObject.IsValid())
 		{
 			if (auto p = Cast<UMulticastDelegateProperty>(Property))
 			{
 				FScriptDelegate Delegate;
-				Delegate.BindUFunction(DelegateObject, NAME_Fire);
+				Delegate.BindUFunction(Dispatcher, NAME_Fire);
 
 				auto Target = p->GetPropertyValuePtr_InContainer(WeakObject.Get());
-				Target->Add(Delegate);
+				Target->AddUnique(Delegate);
 			}
 			else if (auto p = Cast<UDelegateProperty>(Property))
 			{
 				auto Target = p->GetPropertyValuePtr_InContainer(WeakObject.Get());
-				Target->BindUFunction(DelegateObject, NAME_Fire);
+				Target->BindUFunction(Dispatcher, NAME_Fire);
 			}
 		}
-
-		DelegateObject->JavascriptDelegate = this;
-		DelegateObject->AddToRoot();
-		DelegateObjects.Add(DelegateObject);
-
-		functions.Add( DelegateObject->UniqueId, UniquePersistent<Function>(isolate_, function) );
 	}
 
-	void Unbind(UJavascriptDelegate* DelegateObject)
+	void UnbindDispatcher()
 	{
 		static FName NAME_Fire("Fire");
 
-		if (WeakObject.IsValid())
+		if (WeakObject.IsValid() && Dispatcher)
 		{
 			if (auto p = Cast<UMulticastDelegateProperty>(Property))
 			{
 				FScriptDelegate Delegate;
-				Delegate.BindUFunction(DelegateObject, NAME_Fire);
+				Delegate.BindUFunction(Dispatcher, NAME_Fire);
 
 				auto Target = p->GetPropertyValuePtr_InContainer(WeakObject.Get());
 				Target->Remove(Delegate);
@@ -253,15 +365,6 @@ public:
 				Target->Clear();
 			}
 		}
-
-		DelegateObject->JavascriptDelegate = nullptr;
-		DelegateObject->RemoveFromRoot();
-		DelegateObjects.Remove(DelegateObject);
-
-		if (!bAbandoned)
-		{
-			functions.Remove(DelegateObject->UniqueId);
-		}
 	}
 
 	UFunction* GetSignatureFunction()
@@ -280,27 +383,219 @@ public:
 		}
 	}
 
-	void Fire(void* Parms, UJavascriptDelegate* Delegate)
+	void EnableBatching(double InBatchWindow, int32 InMaxBatchSize)
+	{
+		if (bAbandoned) return;
+
+		auto Signature = GetSignatureFunction();
+		for (TFieldIterator<UProperty> It(Signature); It && (It->PropertyFlags & CPF_Parm); ++It)
+		{
+			if (It->HasAnyPropertyFlags(CPF_ReturnParm) || (It->PropertyFlags & (CPF_ConstParm | CPF_OutParm)) == CPF_OutParm)
+			{
+				UE_LOG(Javascript, Warning, TEXT("%s has out parameters or return value, can't be batched"), *Property->GetName());
+				return;
+			}
+
+			// Queued object parameters are reported to GC (see AddReferencedObjects), references nested in structs or arrays can't be
+			if (!It->IsA<UObjectPropertyBase>() && It->ContainsObjectReference())
+			{
+				UE_LOG(Javascript, Warning, TEXT("%s has object references within parameter %s, can't be batched"), *Property->GetName(), *It->GetName());
+				return;
+			}
+		}
+
+		BatchWindow = FMath::Max(InBatchWindow, 0.0);
+		MaxBatchSize = FMath::Max(InMaxBatchSize, 1);
+		BatchStride = Align(FMath::Max(Signature->ParmsSize, 1), FMath::Max(Signature->GetMinAlignment(), 1));
+
+		if (!bBatched)
+		{
+			bBatched = true;
+			BatchedDelegates->Add(this);
+		}
+	}
+
+	void DisableBatching()
+	{
+		if (!bBatched) return;
+
+		DeliverBatch();
+		DestroyBatch();
+
+		bBatched = false;
+		BatchedDelegates->Remove(this);
+	}
+
+	void Enqueue(void* Parms)
 	{
-		auto Buffer = reinterpret_cast<uint8*>(Parms);
+		auto Signature = GetSignatureFunction();
 
-		auto it = functions.Find(Delegate->UniqueId);
-		if (WeakObject.IsValid() && it)
+		if (NumBatched == 0)
 		{
-			Isolate::Scope isolate_scope(isolate_);
-			HandleScope handle_scope(isolate_);
+			FirstBatchedTime = FPlatformTime::Seconds();
+		}
+
+		BatchArena.AddUninitialized(BatchStride);
+		auto Event = BatchArena.GetData() + NumBatched * BatchStride;
+		NumBatched++;
+
+		for (TFieldIterator<UProperty> It(Signature); It && (It->PropertyFlags & CPF_Parm); ++It)
+		{
+			It->InitializeValue_InContainer(Event);
+			It->CopyCompleteValue_InContainer(Event, Parms);
+		}
+
+		INC_DWORD_STAT(STAT_JavascriptBatchedDelegateEvents);
+
+		if (NumBatched >= MaxBatchSize)
+		{
+			DeliverBatch();
+		}
+	}
+
+	void DestroyBatch()
+	{
+		auto Signature = GetSignatureFunction();
+
+		for (int32 Index = 0; Index < NumBatched; ++Index)
+		{
+			auto Event = BatchArena.GetData() + Index * BatchStride;
+			for (TFieldIterator<UProperty> It(Signature); It && (It->PropertyFlags & CPF_Parm); ++It)
+			{
+				It->DestroyValue_InContainer(Event);
+			}
+		}
+
+		// Keep the arena's allocation for the next batch
+		BatchArena.Reset();
+		NumBatched = 0;
+	}
+
+	// Called every frame by FDelegateManager
+	void TickBatch(double Now)
+	{
+		if (NumBatched && Now - FirstBatchedTime >= BatchWindow)
+		{
+			DeliverBatch();
+		}
+	}
+
+	void DeliverBatch()
+	{
+		if (NumBatched == 0) return;
+
+		if (!WeakObject.IsValid() || Listeners.Num() == 0)
+		{
+			DestroyBatch();
+			return;
+		}
+
+		Isolate::Scope isolate_scope(isolate_);
+		HandleScope handle_scope(isolate_);
+
+		auto context = Local<Context>::New(isolate_, context_);
+
+		Context::Scope context_scope(context);
+
+		auto Signature = GetSignatureFunction();
+		auto Events = Array::New(isolate_, NumBatched);
+
+		for (int32 Index = 0; Index < NumBatched; ++Index)
+		{
+			auto Buffer = BatchArena.GetData() + Index * BatchStride;
+			auto Event = Object::New(isolate_);
+			for (TFieldIterator<UProperty> It(Signature); It && (It->PropertyFlags & CPF_Parm); ++It)
+			{
+				Event->Set(V8_KeywordString(isolate_, It->GetFName()), ReadProperty(isolate_, *It, Buffer, FNoPropertyOwner()));
+			}
+			Events->Set(Index, Event);
+		}
+
+		// Listeners may fire this delegate again
+		auto NumEvents = NumBatched;
+		DestroyBatch();
+
+		TArray<int32, TInlineAllocator<8>> ListenersToCall(Listeners);
+
+		FTypedArrayViews::ValidateViews(isolate_);
+
+		for (auto Id : ListenersToCall)
+		{
+			auto it = functions.Find(Id);
+			if (!it) continue;
 
 			auto func = Local<Function>::New(isolate_, *it);
-			if (!func.IsEmpty())
+
+			TryCatch try_catch;
+
+			Local<Value> argv[] = { Events };
+			func->Call(context->Global(), 1, argv);
+
+			if (try_catch.HasCaught())
 			{
-				auto context = Local<Context>::New(isolate_, context_);
+				FV8Exception::Report(try_catch);
+			}
+		}
+
+		INC_DWORD_STAT_BY(STAT_JavascriptDelegateTransitionsSaved, (NumEvents - 1) * ListenersToCall.Num());
+	}
 
-				Context::Scope context_sopce(context);
+	void Fire(void* Parms)
+	{
+		if (!WeakObject.IsValid() || Listeners.Num() == 0) return;
 
+		if (bBatched)
+		{
+			Enqueue(Parms);
+			return;
+		}
+
+		Isolate::Scope isolate_scope(isolate_);
+		HandleScope handle_scope(isolate_);
+
+		auto context = Local<Context>::New(isolate_, context_);
+
+		Context::Scope context_sopce(context);
+
+		// Listeners may add or remove listeners
+		TArray<int32, TInlineAllocator<8>> ListenersToCall(Listeners);
+
+		for (auto Id : ListenersToCall)
+		{
+			auto it = functions.Find(Id);
+			if (!it) continue;
+
+			auto func = Local<Function>::New(isolate_, *it);
+			if (!func.IsEmpty())
+			{
 				CallJavascriptFunction(context, context->Global(), GetSignatureFunction(), func, Parms);
 			}
 		}
 	}
+
+	void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+	{
+		if (Dispatcher)
+		{
+			Collector.AddReferencedObject(Dispatcher, InThis);
+		}
+
+		// Objects passed to queued events stay alive until they are delivered
+		if (NumBatched)
+		{
+			for (TFieldIterator<UObjectProperty> It(GetSignatureFunction()); It && (It->PropertyFlags & CPF_Parm); ++It)
+			{
+				for (int32 Index = 0; Index < NumBatched; ++Index)
+				{
+					auto Event = BatchArena.GetData() + Index * BatchStride;
+					for (int32 ArrayIndex = 0; ArrayIndex < It->ArrayDim; ++ArrayIndex)
+					{
+						Collector.AddReferencedObject(*It->GetPropertyValuePtr_InContainer(Event, ArrayIndex), InThis);
+					}
+				}
+			}
+		}
+	}
 };
 
 struct FDelegateManager : IDelegateManager
@@ -308,7 +603,7 @@ struct FDelegateManager : IDelegateManager
 	Isolate* isolate_;
 
 	FDelegateManager(Isolate* isolate)
-		: isolate_(isolate)
+		: isolate_(isolate), SweepCursor(0)
 	{}
 
 	~FDelegateManager()
@@ -321,52 +616,104 @@ struct FDelegateManager : IDelegateManager
 		delete this;
 	}
 
-	TSet<FJavascriptDelegate*> Delegates;
+	TArray<FJavascriptDelegate*> Delegates;
+
+	// Next delegate to be checked by SweepDelegates
+	int32 SweepCursor;
+
+	// Delegates in batched mode
+	TSet<FJavascriptDelegate*> BatchedDelegates;
+
+	virtual void FlushBatchedDelegates() override
+	{
+		if (BatchedDelegates.Num() == 0) return;
+
+		auto Now = FPlatformTime::Seconds();
+
+		// Listeners may change batching of any delegate
+		for (auto d : BatchedDelegates.Array())
+		{
+			if (BatchedDelegates.Contains(d))
+			{
+				d->TickBatch(Now);
+			}
+		}
+	}
 
-	void CollectGarbageDelegates()
+	// Releases delegates whose object has gone, checking at most MaxDelegates of them (0 : all).
+	// They are deleted once Javascript doesn't reference them any more.
+	virtual void SweepDelegates(int32 MaxDelegates) override
 	{
-		for (auto it = Delegates.CreateIterator(); it; ++it)
+		int32 NumToCheck = MaxDelegates > 0 ? FMath::Min(MaxDelegates, Delegates.Num()) : Delegates.Num();
+
+		for (int32 Checked = 0; Checked < NumToCheck && Delegates.Num(); ++Checked)
 		{
-			auto d = *it;
+			if (SweepCursor >= Delegates.Num())
+			{
+				SweepCursor = 0;
+			}
+
+			auto d = Delegates[SweepCursor];
 			if (!d->IsValid())
+			{
+				d->Purge();
+			}
+
+			if (d->CanBeDeleted())
 			{
 				delete d;
-				it.RemoveCurrent();
+				Delegates.RemoveAtSwap(SweepCursor);
+				DEC_DWORD_STAT(STAT_JavascriptDelegates);
+				INC_DWORD_STAT(STAT_JavascriptSweptDelegates);
+			}
+			else
+			{
+				SweepCursor++;
 			}
 		}
 	}
 
+	virtual void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector) override
+	{
+		for (auto d : Delegates)
+		{
+			d->AddReferencedObjects(InThis, Collector);
+		}
+	}
+
 	void PurgeAllDelegates()
 	{
 		for (auto d : Delegates)
 		{
 			delete d;
 		}
+		DEC_DWORD_STAT_BY(STAT_JavascriptDelegates, Delegates.Num());
 		Delegates.Empty();
+		SweepCursor = 0;
 	}
 
 	Local<Object> CreateDelegate(UObject* Object, UProperty* Property)
 	{
-		//@HACK
-		CollectGarbageDelegates();
-
 		auto payload = new FJavascriptDelegate(Object, Property);
+		payload->BatchedDelegates = &BatchedDelegates;
 		auto created = payload->Initialize(isolate_->GetCurrentContext());
 
 		Delegates.Add(payload);
+		INC_DWORD_STAT(STAT_JavascriptDelegates);
 
 		return created;
 	}
 
+	// Proxies are cached in hidden values (keyed by property name), which don't change the shape of the wrapper
 	virtual Local<Value> GetProxy(Local<Object> This, UObject* Object, UProperty* Property) override
 	{
-		auto cache_id = V8_KeywordString(isolate_, FString::Printf(TEXT("$internal_%s"), *(Property->GetName())));
-		auto cached = This->Get(cache_id);
+		auto cache_id = V8_KeywordString(isolate_, Property->GetFName());
+		auto cached = This->GetHiddenValue(cache_id);
 		if (cached.IsEmpty() || cached->IsUndefined())
 		{
 			auto created = CreateDelegate(Object, Property);
 
-			This->Set(cache_id, created);
+			This->SetHiddenValue(cache_id, created);
 			return created;
 		}
 		else
@@ -382,6 +729,22 @@ namespace v8
 	{
 		return new FDelegateManager(isolate);
 	}
+
+	int32 IDelegateManager::CollectListeners(Isolate* isolate, UJavascriptDelegate* Dispatcher, Local<Array> Out, int32 Index)
+	{
+		auto payload = Dispatcher->JavascriptDelegate;
+		if (!payload || !payload->IsValid()) return 0;
+
+		int32 Num = 0;
+		for (auto Id : payload->Listeners)
+		{
+			if (auto func = payload->functions.Find(Id))
+			{
+				Out->Set(Index + Num++, Local<Function>::New(isolate, *func));
+			}
+		}
+		return Num;
+	}
 }
 
 void UJavascriptDelegate::Fire()
@@ -391,6 +754,40 @@ void UJavascriptDelegate::ProcessEvent(UFunction* Function, void* Parms)
 {
 	if (JavascriptDelegate)
 	{
-		JavascriptDelegate->Fire(Parms, this);
+		JavascriptDelegate->Fire(Parms);
 	}
-}
\ No newline at end of file
+}
+static void BenchmarkDelegates(const TArray<FString>& Args)
+{
+	int32 NumListeners = FMath::Max(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 5000, 1);
+
+	auto Isolate = NewObject<UJavascriptIsolate>();
+	auto Context = Isolate->CreateContext();
+	auto Watcher = NewObject<UDirectoryWatcher>();
+	Context->Expose(TEXT("Watcher"), Watcher);
+
+	Context->RunScript(FString::Printf(TEXT("var listeners = []; for (var i = 0; i < %d; ++i) listeners.push(function () {});"), NumListeners), false);
+
+	auto Measure = [&](const TCHAR* Script) -> double {
+		double StartTime = FPlatformTime::Seconds();
+		Context->RunScript(Script, false);
+		return (FPlatformTime::Seconds() - StartTime) * 1000;
+	};
+
+	double AddTime = Measure(TEXT("listeners.forEach(function (f) { Watcher.OnChanged.Add(f); });"));
+
+	double StartTime = FPlatformTime::Seconds();
+	Watcher->OnChanged.Broadcast();
+	double BroadcastTime = (FPlatformTime::Seconds() - StartTime) * 1000;
+
+	double GetTime = Measure(TEXT("for (var i = 0; i < listeners.length; ++i) Watcher.OnChanged;"));
+	double RemoveTime = Measure(TEXT("listeners.reverse().forEach(function (f) { Watcher.OnChanged.Remove(f); });"));
+
+	UE_LOG(Javascript, Log, TEXT("%d listeners : add %.2fms, broadcast %.2fms, %d proxy reads %.2fms, remove %.2fms"), NumListeners, AddTime, BroadcastTime, NumListeners, GetTime, RemoveTime);
+}
+
+static FAutoConsoleCommand BenchmarkDelegatesCommand(
+	TEXT("Javascript.BenchmarkDelegates"),
+	TEXT("Measures adding, firing and removing Javascript delegate listeners. Usage: Javascript.BenchmarkDelegates [Listeners]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkDelegates)
+	);
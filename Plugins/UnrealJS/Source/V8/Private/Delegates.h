@@ -1,11 +1,19 @@
 #pragma once
 
+class UJavascriptDelegate;
+
 namespace v8
 {
 	struct IDelegateManager
 	{
 		static IDelegateManager* Create(Isolate* isolate);
+
+		/** Appends Javascript listeners bound through Dispatcher to Out (from Index), returns the number appended */
+		static int32 CollectListeners(Isolate* isolate, UJavascriptDelegate* Dispatcher, Local<Array> Out, int32 Index);
 		virtual void Destroy() = 0;
 		virtual Local<Value> GetProxy(Local<Object> This, UObject* Object, UProperty* Property) = 0;
+		virtual void SweepDelegates(int32 MaxDelegates) = 0;
+		virtual void FlushBatchedDelegates() = 0;
+		virtual void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector) = 0;
 	};
 }
\ No newline at end of file
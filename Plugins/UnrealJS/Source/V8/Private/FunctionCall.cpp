@@ -2,6 +2,7 @@
 #include "Translator.h"
 #include "Exception.h"
 #include "Helpers.h"
+#include "TypedArrays.h"
 
 namespace v8
 {
@@ -36,6 +37,8 @@ namespace v8
 			}
 		}
 
+		FTypedArrayViews::ValidateViews(isolate);
+
 		TryCatch try_catch;		
 
 		auto value = func->Call(This, argc, argv);
@@ -88,7 +91,7 @@ namespace v8
 				// rejects 'const T&' and pass 'T&' as its name
 				else if ((PropertyFlags & (CPF_ConstParm | CPF_OutParm)) == CPF_OutParm)
 				{
-					auto sub_value = Object->Get(I.Keyword(Param->GetName()));
+					auto sub_value = Object->Get(I.Keyword(Param->GetFName()));
 
 					if (!sub_value.IsEmpty())
 					{
@@ -0,0 +1,175 @@
+#include "V8PCH.h"
+#include "GCScheduler.h"
+#include "JavascriptSettings.h"
+#include "IV8.h"
+
+using namespace v8;
+
+DECLARE_CYCLE_STAT(TEXT("Idle GC"), STAT_JavascriptIdleGC, STATGROUP_Javascript);
+DECLARE_CYCLE_STAT(TEXT("Full GC"), STAT_JavascriptFullGC, STATGROUP_Javascript);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("V8 GC time (ms)"), STAT_JavascriptGCTime, STATGROUP_Javascript);
+DECLARE_DWORD_COUNTER_STAT(TEXT("V8 GCs"), STAT_JavascriptNumGCs, STATGROUP_Javascript);
+
+// Don't flood V8 with low memory notifications while the heap stays above the limit
+static const double LowMemoryNotificationInterval = 5.0;
+
+TArray<FJavascriptGCScheduler*> FJavascriptGCScheduler::Schedulers;
+double FJavascriptGCScheduler::FrameStartTime = 0;
+FDelegateHandle FJavascriptGCScheduler::OnBeginFrameHandle;
+FDelegateHandle FJavascriptGCScheduler::OnEndFrameHandle;
+
+FJavascriptGCScheduler::FJavascriptGCScheduler(Isolate* InIsolate)
+	: isolate_(InIsolate), LastLowMemoryNotificationTime(0), GCStartTime(0), GCTimeThisFrame(0), NumGCsThisFrame(0)
+{
+	isolate_->SetData(DataSlot, this);
+
+	isolate_->AddGCPrologueCallback(&FJavascriptGCScheduler::OnGCPrologue);
+	isolate_->AddGCEpilogueCallback(&FJavascriptGCScheduler::OnGCEpilogue);
+
+	if (Schedulers.Num() == 0)
+	{
+		FrameStartTime = FPlatformTime::Seconds();
+		OnBeginFrameHandle = FCoreDelegates::OnBeginFrame.AddStatic(&FJavascriptGCScheduler::OnBeginFrame);
+		OnEndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&FJavascriptGCScheduler::OnEndFrame);
+	}
+
+	Schedulers.Add(this);
+}
+
+FJavascriptGCScheduler::~FJavascriptGCScheduler()
+{
+	Schedulers.Remove(this);
+
+	if (Schedulers.Num() == 0)
+	{
+		FCoreDelegates::OnBeginFrame.Remove(OnBeginFrameHandle);
+		FCoreDelegates::OnEndFrame.Remove(OnEndFrameHandle);
+	}
+
+	isolate_->RemoveGCPrologueCallback(&FJavascriptGCScheduler::OnGCPrologue);
+	isolate_->RemoveGCEpilogueCallback(&FJavascriptGCScheduler::OnGCEpilogue);
+
+	isolate_->SetData(DataSlot, nullptr);
+}
+
+void FJavascriptGCScheduler::CollectAll()
+{
+	SCOPE_CYCLE_COUNTER(STAT_JavascriptFullGC);
+
+	Isolate::Scope isolate_scope(isolate_);
+
+	// Full collection (twice, to get rid of what the first one has made unreachable) and shrinks the heap
+	isolate_->LowMemoryNotification();
+}
+
+void FJavascriptGCScheduler::OnEngineGarbageCollection()
+{
+	if (GetDefault<UJavascriptSettings>()->GCPolicy == EJavascriptGCPolicy::OnEngineGC)
+	{
+		CollectAll();
+	}
+}
+
+void FJavascriptGCScheduler::OnBeginFrame()
+{
+	FrameStartTime = FPlatformTime::Seconds();
+}
+
+void FJavascriptGCScheduler::OnEndFrame()
+{
+	auto Settings = GetDefault<UJavascriptSettings>();
+	const double Now = FPlatformTime::Seconds();
+
+	double IdleTime = 0;
+	switch (Settings->GCPolicy)
+	{
+	case EJavascriptGCPolicy::Idle:
+		// Whatever is left of the frame budget
+		IdleTime = FMath::Min(Settings->TargetFrameTimeMs / 1000.0 - (Now - FrameStartTime), Settings->MaxIdleTimeMs / 1000.0);
+		break;
+	case EJavascriptGCPolicy::Budgeted:
+		IdleTime = Settings->MaxIdleTimeMs / 1000.0;
+		break;
+	default:
+		break;
+	}
+
+	// Isolates share the budget of the frame : each gets an even split of what is left,
+	// so time not used by one of them goes to the next.
+	if (IdleTime > 0)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_JavascriptIdleGC);
+
+		const double Deadline = IV8::Get().MonotonicallyIncreasingTime() + IdleTime;
+
+		for (int32 Index = 0; Index < Schedulers.Num(); ++Index)
+		{
+			const double Left = Deadline - IV8::Get().MonotonicallyIncreasingTime();
+			if (Left <= 0) break;
+
+			Schedulers[Index]->IdleUntil(Deadline - Left + Left / (Schedulers.Num() - Index));
+		}
+	}
+
+	for (auto Scheduler : Schedulers)
+	{
+		Scheduler->CheckHeapSize(Now);
+		Scheduler->FlushStats();
+	}
+}
+
+void FJavascriptGCScheduler::IdleUntil(double Deadline)
+{
+	Isolate::Scope isolate_scope(isolate_);
+	isolate_->IdleNotificationDeadline(Deadline);
+}
+
+void FJavascriptGCScheduler::CheckHeapSize(double Now)
+{
+	auto Settings = GetDefault<UJavascriptSettings>();
+
+	// Full collections only under real memory pressure
+	if (Settings->LowMemoryHeapSizeMB > 0 && Now - LastLowMemoryNotificationTime > LowMemoryNotificationInterval)
+	{
+		HeapStatistics Statistics;
+		isolate_->GetHeapStatistics(&Statistics);
+
+		if (Statistics.used_heap_size() > (size_t)Settings->LowMemoryHeapSizeMB * 1024 * 1024)
+		{
+			SCOPE_CYCLE_COUNTER(STAT_JavascriptFullGC);
+
+			Isolate::Scope isolate_scope(isolate_);
+			isolate_->LowMemoryNotification();
+
+			LastLowMemoryNotificationTime = Now;
+		}
+	}
+}
+
+void FJavascriptGCScheduler::FlushStats()
+{
+	INC_FLOAT_STAT_BY(STAT_JavascriptGCTime, GCTimeThisFrame * 1000);
+	INC_DWORD_STAT_BY(STAT_JavascriptNumGCs, NumGCsThisFrame);
+
+	GCTimeThisFrame = 0;
+	NumGCsThisFrame = 0;
+}
+
+void FJavascriptGCScheduler::OnGCPrologue(Isolate* isolate, GCType type, GCCallbackFlags flags)
+{
+	auto Self = reinterpret_cast<FJavascriptGCScheduler*>(isolate->GetData(DataSlot));
+	if (Self)
+	{
+		Self->GCStartTime = FPlatformTime::Seconds();
+	}
+}
+
+void FJavascriptGCScheduler::OnGCEpilogue(Isolate* isolate, GCType type, GCCallbackFlags flags)
+{
+	auto Self = reinterpret_cast<FJavascriptGCScheduler*>(isolate->GetData(DataSlot));
+	if (Self)
+	{
+		Self->GCTimeThisFrame += FPlatformTime::Seconds() - Self->GCStartTime;
+		Self->NumGCsThisFrame++;
+	}
+}
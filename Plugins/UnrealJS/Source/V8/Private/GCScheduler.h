@@ -0,0 +1,51 @@
+#pragma once
+
+/**
+ * Drives V8 garbage collection of an isolate from the engine's frame loop (see UJavascriptSettings::GCPolicy)
+ * One idle budget per frame is shared by all isolates, see OnEndFrame.
+ * Also measures time spent in V8 GC per frame (stat Javascript/V8 GC time).
+ * Lives in isolate data slot (FJavascriptGCScheduler::DataSlot), so that GC callbacks can find it.
+ */
+class FJavascriptGCScheduler
+{
+public:
+	enum { DataSlot = 2 };
+
+	FJavascriptGCScheduler(v8::Isolate* InIsolate);
+	~FJavascriptGCScheduler();
+
+	/** Full stop-the-world collection right now */
+	void CollectAll();
+
+	/** Called once per UE garbage collection */
+	void OnEngineGarbageCollection();
+
+private:
+	static void OnBeginFrame();
+	static void OnEndFrame();
+
+	/** Idle GC until Deadline (seconds, monotonic clock of V8 platform) */
+	void IdleUntil(double Deadline);
+
+	/** Low memory notification if heap is above UJavascriptSettings::LowMemoryHeapSizeMB */
+	void CheckHeapSize(double Now);
+
+	void FlushStats();
+
+	static TArray<FJavascriptGCScheduler*> Schedulers;
+	static double FrameStartTime;
+	static FDelegateHandle OnBeginFrameHandle;
+	static FDelegateHandle OnEndFrameHandle;
+
+	static void OnGCPrologue(v8::Isolate* isolate, v8::GCType type, v8::GCCallbackFlags flags);
+	static void OnGCEpilogue(v8::Isolate* isolate, v8::GCType type, v8::GCCallbackFlags flags);
+
+	v8::Isolate* isolate_;
+
+	double LastLowMemoryNotificationTime;
+
+	// V8 GC timing of this frame
+	double GCStartTime;
+	double GCTimeThisFrame;
+	int32 NumGCsThisFrame;
+};
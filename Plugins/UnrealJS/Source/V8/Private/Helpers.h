@@ -18,6 +18,11 @@ struct FIsolateHelper
 		return V8_KeywordString(isolate_, String);
 	}
 
+	FORCEINLINE v8::Local<v8::String> Keyword(FName Name)
+	{
+		return V8_KeywordString(isolate_, Name);
+	}
+
 	FORCEINLINE v8::Local<v8::String> String(const FString& InString)
 	{
 		return V8_String(isolate_, InString);
@@ -0,0 +1,20 @@
+#include "V8PCH.h"
+#include "JavascriptBundleCommandlet.h"
+#include "ScriptBundle.h"
+#include "IV8.h"
+
+UJavascriptBundleCommandlet::UJavascriptBundleCommandlet(const FObjectInitializer& ObjectInitializer)
+: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UJavascriptBundleCommandlet::Main(const FString& Params)
+{
+	const bool bCodeCache = !FParse::Param(*Params, TEXT("NoCodeCache"));
+
+	return FJavascriptScriptBundle::Build(IV8::Get().GetGlobalScriptSearchPaths(), bCodeCache) ? 0 : 1;
+}
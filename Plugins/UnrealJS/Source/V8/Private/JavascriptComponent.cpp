@@ -2,6 +2,9 @@
 #include "JavascriptComponent.h"
 #include "JavascriptIsolate.h"
 #include "JavascriptContext.h"
+#include "JavascriptIsolatePool.h"
+#include "JavascriptTickManager.h"
+#include "JavascriptSettings.h"
 #include "IV8.h"
 
 UJavascriptComponent::UJavascriptComponent(const FObjectInitializer& ObjectInitializer)
@@ -11,6 +14,9 @@ UJavascriptComponent::UJavascriptComponent(const FObjectInitializer& ObjectIniti
 	bTickInEditor = false;
 	bAutoActivate = true;
 	bWantsInitializeComponent = true;
+	bTickBatched = false;
+	TickInterval = 0.0f;
+	TimeSinceLastTick = 0.0f;
 }
 
 void UJavascriptComponent::OnRegister()
@@ -20,9 +26,12 @@ void UJavascriptComponent::OnRegister()
 	{
 		if (GetWorld() && (GetWorld()->IsGameWorld() || bActiveWithinEditor))
 		{
-			auto Isolate = NewObject<UJavascriptIsolate>();
+			ReleaseContext();
+
+			auto Isolate = FJavascriptIsolatePool::Acquire(GetWorld());
 			auto Context = Isolate->CreateContext();
 
+			JavascriptIsolate = Isolate;
 			JavascriptContext = Context;
 
 			Context->Expose("Root", this);
@@ -62,21 +71,71 @@ void UJavascriptComponent::BeginDestroy()
 		Deactivate();
 	}
 
+	ReleaseContext();
+
 	Super::BeginDestroy();
 }
 
+void UJavascriptComponent::ReleaseContext()
+{
+	if (JavascriptIsolate)
+	{
+		FJavascriptIsolatePool::Release(JavascriptIsolate);
+	}
+
+	JavascriptIsolate = nullptr;
+	JavascriptContext = nullptr;
+}
+
 void UJavascriptComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
 {
 	check(bRegistered);
 
+	// FJavascriptTickManager honors TickInterval for batched ticks
+	if (!bTickBatched)
+	{
+		TimeSinceLastTick += DeltaTime;
+		if (TimeSinceLastTick < TickInterval) return;
+
+		DeltaTime = TimeSinceLastTick;
+		TimeSinceLastTick = 0.0f;
+	}
+
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-	OnTick.ExecuteIfBound(DeltaTime);
+	// Batched ticks are dispatched to script by FJavascriptTickManager
+	if (!bTickBatched)
+	{
+		OnTick.ExecuteIfBound(DeltaTime);
+	}
+}
+
+void UJavascriptComponent::RegisterComponentTickFunctions(bool bRegister)
+{
+	if (bRegister)
+	{
+		if (!bTickBatched && GetDefault<UJavascriptSettings>()->bBatchComponentTicks && PrimaryComponentTick.bCanEverTick && !IsTemplate() && FJavascriptTickManager::Register(this))
+		{
+			bTickBatched = true;
+			return;
+		}
+	}
+	else if (bTickBatched)
+	{
+		FJavascriptTickManager::Unregister(this);
+		bTickBatched = false;
+		return;
+	}
+
+	Super::RegisterComponentTickFunctions(bRegister);
 }
 
 void UJavascriptComponent::ForceGC()
 {
-	JavascriptContext->RunScript(TEXT("gc();"));
+	if (JavascriptIsolate)
+	{
+		JavascriptIsolate->ForceGC();
+	}
 }
 
 void UJavascriptComponent::Expose(FString ExposedAs, UObject* Object)
@@ -2,11 +2,20 @@
 #include "JavascriptIsolate.h"
 #include "JavascriptContext.h"
 #include "JavascriptComponent.h"
+#include "JavascriptDelegate.h"
 #include "FileManager.h"
 #include "Config.h"
 #include "Translator.h"
 #include "Exception.h"
 #include "IV8.h"
+#include "JavascriptSnapshot.h"
+#include "CodeCache.h"
+#include "Delegates.h"
+#include "JavascriptTimers.h"
+#include "ModuleResolver.h"
+#include "ScriptBundle.h"
+#include "AsyncScriptLoader.h"
+#include "TypedArrays.h"
 
 #include "JavascriptIsolate_Private.h"
 #include "JavascriptContext_Private.h"
@@ -22,6 +31,15 @@
 
 using namespace v8;
 
+DECLARE_CYCLE_STAT(TEXT("Create context"), STAT_JavascriptCreateContext, STATGROUP_Javascript);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Proxy function hits"), STAT_JavascriptProxyFunctionHits, STATGROUP_Javascript);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Proxy function misses"), STAT_JavascriptProxyFunctionMisses, STATGROUP_Javascript);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Require resolution hits"), STAT_JavascriptRequireHits, STATGROUP_Javascript);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Require resolution misses"), STAT_JavascriptRequireMisses, STATGROUP_Javascript);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Async script loads"), STAT_JavascriptAsyncLoads, STATGROUP_Javascript);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Streamed script compilations"), STAT_JavascriptStreamedCompilations, STATGROUP_Javascript);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Hot reloaded modules"), STAT_JavascriptHotReloadedModules, STATGROUP_Javascript);
+
 static const int kContextEmbedderDataIndex = 1;
 static const int32 MagicNumber = 0x2852abd3;
 
@@ -298,6 +316,10 @@ class FJavascriptContextImplementation : public FJavascriptContext
 	Persistent<Context> context_;
 	IJavascriptDebugger* debugger{ nullptr };
 
+	// setTimeout/setInterval/process.nextTick, ticked at the end of every frame
+	FJavascriptTimers* Timers{ nullptr };
+	FDelegateHandle OnEndFrameHandle;
+
 	TMap<FString, UObject*> WKOs;
 
 public:
@@ -310,6 +332,12 @@ public:
 	TMap<FString, UniquePersistent<Value>> Modules;
 	TArray<FString>& Paths;
 
+	/** Module functions compiled within startup snapshot, see InstantiateModule (key : path relative to script search path) */
+	TMap<FString, UniquePersistent<Value>> SnapshotModules;
+
+	/** Scripts which are already run within startup snapshot */
+	TSet<FString> SnapshotScripts;
+
 	void SetAsDebugContext()
 	{
 		if (debugger) return;
@@ -320,6 +348,17 @@ public:
 		debugger = IJavascriptDebugger::Create(5858, context());
 	}
 
+	void OnEndFrame()
+	{
+		Isolate::Scope isolate_scope(isolate());
+		HandleScope handle_scope(isolate());
+		Context::Scope context_scope(context());
+
+		FinishLoads();
+
+		Timers->Tick(context(), FApp::GetDeltaTime());
+	}
+
 	bool IsDebugContext() const
 	{
 		return debugger != nullptr;
@@ -340,6 +379,8 @@ public:
 	FJavascriptContextImplementation(TSharedPtr<FJavascriptIsolate> InEnvironment, TArray<FString>& InPaths)
 		: FJavascriptContext(InEnvironment), Paths(InPaths)
 	{
+		SCOPE_CYCLE_COUNTER(STAT_JavascriptCreateContext);
+
 		Isolate::Scope isolate_scope(isolate());
 		HandleScope handle_scope(isolate());
 
@@ -348,15 +389,36 @@ public:
 
 		context_.Reset(isolate(), context);
 
+		Timers = new FJavascriptTimers(isolate());
+
 		ExposeGlobals();
 
 		Paths = IV8::Get().GetGlobalScriptSearchPaths();
+
+		// Before any script is read, async loads read from it on workers
+		FJavascriptScriptBundle::Mount();
+
+		for (const auto& Path : Paths)
+		{
+			FJavascriptModuleResolver::Watch(Path);
+		}
+
+		OnEndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FJavascriptContextImplementation::OnEndFrame);
 	}
 
 	~FJavascriptContextImplementation()
 	{
+		FCoreDelegates::OnEndFrame.Remove(OnEndFrameHandle);
+
+		ReleasePendingLoads();
+
+		delete Timers;
+		Timers = nullptr;
+
 		PurgeModules();
 
+		SnapshotModules.Empty();
+
 		ReleaseAllPersistentHandles();
 
 		ResetAsDebugContext();
@@ -371,6 +433,17 @@ public:
 
 		// Release all struct instances
 		MemoryToObjectMap.Empty();
+
+		// Release all functions held by FJavascriptFunctionHandle
+		FunctionHandles.Empty();
+
+		ProxyFunctionCache.Empty();
+		HolderProxyGenerations.Empty();
+
+		TickDispatcher.Reset();
+
+		ReleaseModuleRecords();
+		ReleaseRequireDirectories();
 	}
 
 	void ExposeGlobals()
@@ -378,13 +451,68 @@ public:
 		HandleScope handle_scope(isolate());
 		Context::Scope context_scope(context());
 
+		ImportSnapshot();
+		Timers->Expose(context());
 		ExposeRequire();
 		ExportUnrealEngineClasses();
 	}
 
+	// Pick up modules and scripts evaluated within startup snapshot
+	void ImportSnapshot()
+	{
+		if (!Environment->IsUsingSnapshot()) return;
+
+		auto global = context()->Global();
+		auto name = V8_KeywordString(isolate(), FJavascriptSnapshot::GlobalName);
+		auto snapshot = global->Get(name);
+		if (snapshot.IsEmpty() || !snapshot->IsObject()) return;
+
+		auto modules = snapshot->ToObject()->Get(V8_KeywordString(isolate(), "modules"))->ToObject();
+		auto module_names = modules->GetOwnPropertyNames();
+		auto NumModules = module_names->Length();
+		for (decltype(NumModules) Index = 0; Index < NumModules; ++Index)
+		{
+			auto module_name = module_names->Get(Index);
+			SnapshotModules.Add(StringFromV8(module_name), UniquePersistent<Value>(isolate(), modules->Get(module_name)));
+		}
+
+		auto scripts = snapshot->ToObject()->Get(V8_KeywordString(isolate(), "scripts"))->ToObject();
+		auto script_names = scripts->GetOwnPropertyNames();
+		auto NumScripts = script_names->Length();
+		for (decltype(NumScripts) Index = 0; Index < NumScripts; ++Index)
+		{
+			SnapshotScripts.Add(StringFromV8(script_names->Get(Index)));
+		}
+
+		global->Delete(name);
+	}
+
+	bool GetScriptRelativePath(const FString& ScriptPath, FString& OutRelativePath)
+	{
+		auto FullPath = FPaths::ConvertRelativePathToFull(ScriptPath);
+		for (const auto& Path : Paths)
+		{
+			auto RootPath = FPaths::ConvertRelativePathToFull(Path);
+			if (!RootPath.EndsWith(TEXT("/")))
+			{
+				RootPath.Append(TEXT("/"));
+			}
+
+			if (FullPath.StartsWith(RootPath))
+			{
+				OutRelativePath = FullPath.Mid(RootPath.Len());
+				return true;
+			}
+		}
+		return false;
+	}
+
 	void PurgeModules()
 	{
 		Modules.Empty();
+
+		// Proxies are mostly defined by modules
+		InvalidateAllProxyFunctions();
 	}
 
 	void ExportUnrealEngineClasses()
@@ -454,22 +582,12 @@ public:
 					auto isolate = Context->isolate();
 					auto Object = ObjectInitializer.GetObj();
 
-					FIsolateHelper I(isolate);
-
 					Isolate::Scope isolate_scope(isolate);
 					HandleScope handle_scope(isolate);
 					Context::Scope context_scope(Context->context());
 
-					auto Holder = Context->ExportObject(Class);					
-
-					auto v8_obj = Holder->ToObject();
-					auto proxy = v8_obj->Get(I.Keyword("proxy"));
-					if (proxy.IsEmpty() || !proxy->IsObject())
-					{
-						I.Throw(TEXT("Invalid proxy : construct class"));
-						return;
-					}
-					auto func = proxy->ToObject()->Get(I.Keyword("ctor"));					
+					// proxy.ctor
+					auto func = Context->GetProxyFunction(Class, (UFunction*)nullptr);
 
 					Context->ObjectInitializer = &ObjectInitializer;
 
@@ -790,249 +908,1056 @@ public:
 		global->Set(V8_KeywordString(isolate(), "CreateClass"), FunctionTemplate::New(isolate(), fn, self)->GetFunction());
 	}
 
-	void ExposeRequire()
+	/** require() bound to a directory, resolved paths are cached per specifier */
+	struct FRequireDirectory
 	{
-		auto fn = [](const FunctionCallbackInfo<Value>& info) {
-			auto isolate = info.GetIsolate();
-			HandleScope scope(isolate);
+		FJavascriptContextImplementation* Context;
+		FString Directory;
+		TMap<FString, FString> Resolved;
+		uint32 Generation;
+	};
 
-			if (info.Length() != 1 || !(info[0]->IsString()))
-			{
-				return;
-			}
+	TMap<FString, FRequireDirectory*> RequireDirectories;
 
-			auto Self = reinterpret_cast<FJavascriptContextImplementation*>((Local<External>::Cast(info.Data()))->Value());
+	FRequireDirectory& GetRequireDirectory(const FString& Directory)
+	{
+		auto& Found = RequireDirectories.FindOrAdd(Directory);
+		if (!Found)
+		{
+			Found = new FRequireDirectory;
+			Found->Context = this;
+			Found->Directory = Directory;
+			Found->Generation = 0;
+
+			FJavascriptModuleResolver::Watch(Directory);
+		}
+		return *Found;
+	}
+
+	void ReleaseRequireDirectories()
+	{
+		for (auto It = RequireDirectories.CreateIterator(); It; ++It)
+		{
+			delete It.Value();
+		}
+		RequireDirectories.Empty();
+	}
 
-			auto required_module = StringFromV8(info[0]);
+	/** module.hot.accept(dependencies, callback) */
+	struct FAcceptHandler
+	{
+		TSet<FString> Dependencies;
+		UniquePersistent<Function> Callback;
+	};
 
-			bool found = false;
+	/** A module in the require graph, kept across reloads. Bound to its require and module.hot functions. */
+	struct FModuleRecord
+	{
+		FJavascriptContextImplementation* Context;
+		FString Path;
+		FRequireDirectory* Directory;
 
-			auto inner = [&](const FString& script_path)
-			{				
-				auto it = Self->Modules.Find(script_path);
-				if (it)
-				{
-					info.GetReturnValue().Set(Local<Value>::New(isolate, *it));
-					found = true;
-					return true;
-				}
+		// Modules required by this one, and which have required this one
+		TSet<FString> Dependencies;
+		TSet<FString> Dependents;
 
-				FString Text;
-				if (FFileHelper::LoadFileToString(Text, *script_path))
+		// module.hot
+		bool bSelfAccepted;
+		TArray<FAcceptHandler> AcceptHandlers;
+		TArray<UniquePersistent<Function>> DisposeHandlers;
+
+		// Filled by dispose handlers, module.hot.data of the next instance
+		UniquePersistent<Object> Data;
+
+		UniquePersistent<Function> Require;
+
+		int32 FindAcceptHandler(const FString& Dependency) const
+		{
+			for (int32 Index = 0; Index < AcceptHandlers.Num(); ++Index)
+			{
+				if (AcceptHandlers[Index].Dependencies.Contains(Dependency))
 				{
-					Text = FString::Printf(TEXT("(function (__dirname) {\nvar module = { exports : {}, filename : __dirname }, exports = module.exports;\n%s\n;return module.exports;}('%s'));"), *Text, *script_path);
-					auto full_path = IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(*script_path);
-#if PLATFORM_WINDOWS
-					full_path = full_path.Replace(TEXT("/"), TEXT("\\"));
-#endif
-					auto exports = Self->RunScript(full_path, Text, 2);
-					if (exports.IsEmpty())
-					{
-						UE_LOG(Javascript, Log, TEXT("Invalid script for require"));
-					}
-					Self->Modules.Add(script_path, UniquePersistent<Value>(isolate, exports));
-					info.GetReturnValue().Set(exports);
-					found = true;
-					return true;
+					return Index;
 				}
+			}
+			return INDEX_NONE;
+		}
+	};
 
-				return false;
-			};
+	TMap<FString, FModuleRecord*> ModuleRecords;
 
-			auto inner_package = [&](const FString& script_path)
-			{
-				FString Text;
-				if (FFileHelper::LoadFileToString(Text, *(script_path / TEXT("package.json"))))
+	FModuleRecord& GetModuleRecord(const FString& script_path)
+	{
+		auto& Found = ModuleRecords.FindOrAdd(script_path);
+		if (!Found)
+		{
+			Found = new FModuleRecord;
+			Found->Context = this;
+			Found->Path = script_path;
+			Found->Directory = &GetRequireDirectory(FPaths::GetPath(script_path));
+			Found->bSelfAccepted = false;
+		}
+		return *Found;
+	}
+
+	void ReleaseModuleRecords()
+	{
+		for (auto It = ModuleRecords.CreateIterator(); It; ++It)
+		{
+			delete It.Value();
+		}
+		ModuleRecords.Empty();
+	}
+
+	void AddDependency(FModuleRecord* Parent, const FString& script_path)
+	{
+		if (Parent)
+		{
+			Parent->Dependencies.Add(script_path);
+			GetModuleRecord(script_path).Dependents.Add(Parent->Path);
+		}
+	}
+
+	// Passed to each module, so that it doesn't need a stack trace to find out where it has been called from
+	Local<Function> GetRequireFunction(FModuleRecord& Record)
+	{
+		if (Record.Require.IsEmpty())
+		{
+			auto fn = [](const FunctionCallbackInfo<Value>& info) {
+				auto Record = reinterpret_cast<FModuleRecord*>((Local<External>::Cast(info.Data()))->Value());
+
+				if (info.Length() != 1 || !(info[0]->IsString()))
 				{
-					Text = FString::Printf(TEXT("(function (json) {return json.main;})(%s);"), *Text);
-					auto full_path = IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(*script_path);
-#if PLATFORM_WINDOWS
-					full_path = full_path.Replace(TEXT("/"), TEXT("\\"));
-#endif
-					auto exports = Self->RunScript(full_path, Text, 0);
-					if (exports.IsEmpty() || !exports->IsString())
-					{
-						return false;
-					}
-					else
-					{
-						return inner(script_path / StringFromV8(exports));
-					}
+					return;
 				}
 
-				return false;
+				info.GetReturnValue().Set(Record->Context->Require(*Record->Directory, StringFromV8(info[0]), Record));
 			};
 
-			auto inner2 = [&](FString base_path)
-			{
-				for (;;)
-				{
-					if (!FPaths::DirectoryExists(base_path)) return false;
+			Record.Require.Reset(isolate(), Function::New(isolate(), fn, External::New(isolate(), &Record)));
+		}
 
-					auto script_path = base_path / required_module;
-					if (!script_path.EndsWith(TEXT(".js")))
-					{
-						if (inner(script_path + TEXT(".js"))) return true;
-						if (inner(script_path / TEXT("index.js"))) return true;
+		return Local<Function>::New(isolate(), Record.Require);
+	}
 
-						if (inner_package(script_path)) return true;
-					}
-					else
-					{
-						if (inner(script_path)) return true;
-					}
+	// module.hot : accept([dependencies, ]callback), dispose(callback), data
+	Local<Object> CreateHotObject(FModuleRecord& Record)
+	{
+		auto accept = [](const FunctionCallbackInfo<Value>& info) {
+			auto isolate = info.GetIsolate();
+			auto Record = reinterpret_cast<FModuleRecord*>((Local<External>::Cast(info.Data()))->Value());
 
-					base_path = base_path / TEXT("node_modules");
+			// Self-accepting : reloaded in place, dependents keep the exports they have
+			if (info.Length() == 0 || info[0]->IsFunction())
+			{
+				Record->bSelfAccepted = true;
+				return;
+			}
+
+			TArray<Local<Value>> Specifiers;
+			if (info[0]->IsArray())
+			{
+				auto arr = Local<Array>::Cast(info[0]);
+				for (uint32_t Index = 0; Index < arr->Length(); ++Index)
+				{
+					Specifiers.Add(arr->Get(Index));
 				}
-			};
+			}
+			else
+			{
+				Specifiers.Add(info[0]);
+			}
 
-			auto current_script_path = FPaths::GetPath(StringFromV8(StackTrace::CurrentStackTrace(isolate, 1, StackTrace::kScriptName)->GetFrame(0)->GetScriptName()));
-#if PLATFORM_WINDOWS
-			current_script_path = current_script_path.Replace(TEXT("\\"), TEXT("/"));
-#endif
-			if (!inner2(current_script_path))
+			auto& Handler = Record->AcceptHandlers[Record->AcceptHandlers.AddDefaulted()];
+			for (auto Specifier : Specifiers)
 			{
-				for (const auto& path : Self->Paths)
+				FString ScriptPath;
+				if (Record->Context->Resolve(*Record->Directory, StringFromV8(Specifier), ScriptPath))
 				{
-					if (inner2(path)) break;
+					Handler.Dependencies.Add(ScriptPath);
 				}
 			}
 
-			if (!found)
+			if (info.Length() > 1 && info[1]->IsFunction())
 			{
-				info.GetReturnValue().Set(Undefined(isolate));
+				Handler.Callback.Reset(isolate, Local<Function>::Cast(info[1]));
 			}
 		};
 
-		auto fn2 = [](const FunctionCallbackInfo<Value>& info) {
+		auto dispose = [](const FunctionCallbackInfo<Value>& info) {
 			auto isolate = info.GetIsolate();
-			HandleScope scope(isolate);
+			auto Record = reinterpret_cast<FModuleRecord*>((Local<External>::Cast(info.Data()))->Value());
 
-			auto Self = reinterpret_cast<FJavascriptContextImplementation*>((Local<External>::Cast(info.Data()))->Value());
-			Self->PurgeModules();
+			if (info.Length() != 1 || !info[0]->IsFunction())
+			{
+				isolate->ThrowException(Exception::TypeError(V8_String(isolate, "callback is not a function")));
+				return;
+			}
+
+			Record->DisposeHandlers[Record->DisposeHandlers.AddDefaulted()].Reset(isolate, Local<Function>::Cast(info[0]));
 		};
 
-		auto global = context()->Global();
-		auto self = External::New(isolate(), this);
+		auto data = External::New(isolate(), &Record);
 
-		global->Set(V8_KeywordString(isolate(), "require"), FunctionTemplate::New(isolate(), fn, self)->GetFunction());
-		global->Set(V8_KeywordString(isolate(), "purge_modules"), FunctionTemplate::New(isolate(), fn2, self)->GetFunction());
+		auto hot = Object::New(isolate());
+		hot->Set(V8_KeywordString(isolate(), "accept"), Function::New(isolate(), accept, data));
+		hot->Set(V8_KeywordString(isolate(), "dispose"), Function::New(isolate(), dispose, data));
+		hot->Set(V8_KeywordString(isolate(), "data"), Record.Data.IsEmpty() ? Local<Value>(Undefined(isolate())) : Local<Value>(Local<Object>::New(isolate(), Record.Data)));
+		return hot;
+	}
 
-		auto getter = [](Local<String> property, const PropertyCallbackInfo<Value>& info) {
-			auto isolate = info.GetIsolate();
-			HandleScope scope(isolate);
+	// Runs dispose handlers, drops exports and edges to dependencies (they are recorded again when it runs)
+	void DisposeModule(FModuleRecord& Record)
+	{
+		auto data = Object::New(isolate());
 
-			auto Self = reinterpret_cast<FJavascriptContextImplementation*>((Local<External>::Cast(info.Data()))->Value());
+		// Handlers may add handlers
+		auto Handlers = MoveTemp(Record.DisposeHandlers);
+		for (const auto& Handler : Handlers)
+		{
+			TryCatch try_catch;
 
-			auto out = Object::New(isolate);
+			Local<Value> argv[] = { data };
+			Local<Function>::New(isolate(), Handler)->Call(context()->Global(), 1, argv);
 
-			for (auto it = Self->Modules.CreateConstIterator(); it; ++it)
+			if (try_catch.HasCaught())
 			{
-				const auto& name = it.Key();
-				const auto& module = it.Value();
-
-				auto FullPath = IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(*name);
-				out->Set(V8_String(isolate, name), V8_String(isolate, TCHAR_TO_UTF8(*FullPath)));
+				FV8Exception::Report(try_catch);
 			}
+		}
 
-			info.GetReturnValue().Set(out);
-		};
-		global->SetAccessor(V8_KeywordString(isolate(), "modules"), getter, 0, self);
-	}
+		Record.Data.Reset(isolate(), data);
+		Record.DisposeHandlers.Empty();
+		Record.AcceptHandlers.Empty();
+		Record.bSelfAccepted = false;
 
-	FString GetScriptFileFullPath(const FString& Filename)
-	{
-		for (auto Path : Paths)
+		for (const auto& Dependency : Record.Dependencies)
 		{
-			auto FullPath = Path / Filename;
-			auto Size = IFileManager::Get().FileSize(*FullPath);
-			if (Size != INDEX_NONE)
+			if (auto Found = ModuleRecords.FindRef(Dependency))
 			{
-				return IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(*FullPath);
+				Found->Dependents.Remove(Record.Path);
 			}
 		}
-		return Filename;
-	}
-
-	FString ReadScriptFile(const FString& Filename)
-	{
-		auto Path = GetScriptFileFullPath(Filename);
-
-		FString Text;
+		Record.Dependencies.Empty();
 
-		FFileHelper::LoadFileToString(Text, *Path);
+		Modules.Remove(Record.Path);
 
-		return Text;
+		// Its file may have changed since the snapshot was built, load it from file from now on
+		FString RelativePath;
+		if (SnapshotModules.Num() && GetScriptRelativePath(Record.Path, RelativePath))
+		{
+			SnapshotModules.Remove(RelativePath);
+		}
 	}
 
-	Local<Value> RunFile(const FString& Filename)
+	/**
+	 * Invalidates modules of changed files and their dependents, up to modules which accept the change.
+	 * Self-accepting modules are loaded again right away, accept(dependencies) handlers are called afterwards.
+	 * Anything else is loaded again by the next require.
+	 */
+	Local<Object> InvalidateModules(const TArray<FString>& Files)
 	{
-		HandleScope handle_scope(isolate());
+		auto StartTime = FPlatformTime::Seconds();
 
-		auto Script = ReadScriptFile(Filename);
+		// Files are full paths (UDirectoryWatcher), modules are keyed by the path they have been resolved to
+		TSet<FString> Changed;
+		for (auto File : Files)
+		{
+			FPaths::NormalizeFilename(File);
+			Changed.Add(FPaths::ConvertRelativePathToFull(File));
+		}
 
-		return RunScript(GetScriptFileFullPath(Filename), Script);
-	}
+		TArray<FString> Queue;
+		for (auto It = ModuleRecords.CreateConstIterator(); It; ++It)
+		{
+			if (Modules.Contains(It.Key()) && Changed.Contains(FPaths::ConvertRelativePathToFull(It.Key())))
+			{
+				Queue.Add(It.Key());
+			}
+		}
 
-	void Public_RunFile(const FString& Filename)
-	{
-		RunFile(Filename);
-	}
+		struct FAcceptCall
+		{
+			FString Path;
+			int32 Handler;
 
-	FString Public_RunScript(const FString& Script, bool bOutput = true)
-	{
-		Isolate::Scope isolate_scope(isolate());
-		HandleScope handle_scope(isolate());
-		Context::Scope context_scope(context());
+			bool operator == (const FAcceptCall& Other) const
+			{
+				return Handler == Other.Handler && Path == Other.Path;
+			}
+		};
 
-		auto ret = RunScript(TEXT("(inline)"), Script);
-		auto str = ret.IsEmpty() ? TEXT("(empty)") : StringFromV8(ret);
+		TArray<FString> Invalidated;
+		TArray<FString> SelfAccepted;
+		TArray<FAcceptCall> AcceptCalls;
 
-		if (bOutput && !ret.IsEmpty())
+		for (int32 Index = 0; Index < Queue.Num(); ++Index)
 		{
-			UE_LOG(Javascript, Log, TEXT("%s"), *str);
-		}		
-		return str;
-	}
+			const auto Path = Queue[Index];
+			if (Invalidated.Contains(Path)) continue;
 
-	// Should be guarded with proper handle scope
-	Local<Value> RunScript(const FString& Filename, const FString& Script, int line_offset = 0)
-	{
-		Isolate::Scope isolate_scope(isolate());
-		Context::Scope context_scope(context());
+			Invalidated.Add(Path);
 
-		TryCatch try_catch;
-		try_catch.SetVerbose(true);
+			auto Record = ModuleRecords.FindRef(Path);
+			if (Record->bSelfAccepted)
+			{
+				SelfAccepted.Add(Path);
+				continue;
+			}
 
-		auto Path = Filename;
-		auto source = V8_String(isolate(), Script);
-		auto path = V8_String(isolate(), Path);
-		ScriptOrigin origin(path, Integer::New(isolate(), -line_offset));
-		auto script = Script::Compile(source, &origin);
+			for (const auto& Dependent : Record->Dependents)
+			{
+				auto Handler = ModuleRecords.FindRef(Dependent)->FindAcceptHandler(Path);
+				if (Handler != INDEX_NONE)
+				{
+					AcceptCalls.AddUnique(FAcceptCall{ Dependent, Handler });
+				}
+				else
+				{
+					Queue.Add(Dependent);
+				}
+			}
+		}
 
-		auto result = script->Run();
-		if (try_catch.HasCaught())
+		for (const auto& Path : Invalidated)
 		{
-			FV8Exception::Report(try_catch);
-			return Local<Value>();
+			DisposeModule(*ModuleRecords.FindRef(Path));
 		}
-		else
+
+		// Reloaded modules may assign new proxy functions
+		if (Invalidated.Num())
 		{
-			return result;
+			InvalidateAllProxyFunctions();
 		}
-	}
 
-	void Expose(FString RootName, UObject* Object)
-	{
-		WKOs.Add(RootName, Object);
+		for (const auto& Path : SelfAccepted)
+		{
+			LoadModule(Path);
+		}
 
-		auto RootGetter = [](Local<String> property, const PropertyCallbackInfo<Value>& info) {
-			auto isolate = info.GetIsolate();
-			info.GetReturnValue().Set(info.Data());
-		};
+		for (const auto& Call : AcceptCalls)
+		{
+			auto Record = ModuleRecords.FindRef(Call.Path);
+			if (!Record->AcceptHandlers.IsValidIndex(Call.Handler) || Record->AcceptHandlers[Call.Handler].Callback.IsEmpty()) continue;
 
-		Isolate::Scope isolate_scope(isolate());
-		HandleScope handle_scope(isolate());
+			TryCatch try_catch;
+
+			Local<Function>::New(isolate(), Record->AcceptHandlers[Call.Handler].Callback)->Call(context()->Global(), 0, nullptr);
+
+			if (try_catch.HasCaught())
+			{
+				FV8Exception::Report(try_catch);
+			}
+		}
+
+		auto ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000;
+
+		INC_DWORD_STAT_BY(STAT_JavascriptHotReloadedModules, Invalidated.Num());
+		UE_LOG(Javascript, Log, TEXT("Hot reload : %d module(s) invalidated, %d accept handler(s) in %.2f ms"), Invalidated.Num(), AcceptCalls.Num(), ElapsedMs);
+
+		auto invalidated = Array::New(isolate(), Invalidated.Num());
+		for (int32 Index = 0; Index < Invalidated.Num(); ++Index)
+		{
+			invalidated->Set(Index, V8_String(isolate(), FPaths::ConvertRelativePathToFull(Invalidated[Index])));
+		}
+
+		auto out = Object::New(isolate());
+		out->Set(V8_KeywordString(isolate(), "invalidated"), invalidated);
+		out->Set(V8_KeywordString(isolate(), "time"), Number::New(isolate(), ElapsedMs));
+		return out;
+	}
+
+	// Parent is the requiring module, null for global require
+	Local<Value> Require(FRequireDirectory& Directory, const FString& Specifier, FModuleRecord* Parent = nullptr)
+	{
+		// Something has changed within script directories
+		if (Directory.Generation != FJavascriptModuleResolver::GetGeneration())
+		{
+			Directory.Resolved.Empty();
+			Directory.Generation = FJavascriptModuleResolver::GetGeneration();
+		}
+
+		FString ScriptPath;
+		if (auto Cached = Directory.Resolved.Find(Specifier))
+		{
+			INC_DWORD_STAT(STAT_JavascriptRequireHits);
+
+			// Copied, loading may add to Resolved
+			ScriptPath = *Cached;
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_JavascriptRequireMisses);
+
+			if (!ResolveUncached(Directory, Specifier, ScriptPath))
+			{
+				return Undefined(isolate());
+			}
+		}
+
+		AddDependency(Parent, ScriptPath);
+
+		return LoadModule(ScriptPath);
+	}
+
+	bool Resolve(FRequireDirectory& Directory, const FString& Specifier, FString& OutScriptPath)
+	{
+		if (Directory.Generation != FJavascriptModuleResolver::GetGeneration())
+		{
+			Directory.Resolved.Empty();
+			Directory.Generation = FJavascriptModuleResolver::GetGeneration();
+		}
+
+		if (auto Cached = Directory.Resolved.Find(Specifier))
+		{
+			OutScriptPath = *Cached;
+			return true;
+		}
+
+		return ResolveUncached(Directory, Specifier, OutScriptPath);
+	}
+
+	// Caller's directory first, then search paths
+	bool ResolveUncached(FRequireDirectory& Directory, const FString& Specifier, FString& OutScriptPath)
+	{
+		bool bResolved = ResolveModule(Directory.Directory, Specifier, OutScriptPath);
+		for (int32 Index = 0; !bResolved && Index < Paths.Num(); ++Index)
+		{
+			bResolved = ResolveModule(Paths[Index], Specifier, OutScriptPath);
+		}
+
+		if (bResolved)
+		{
+			Directory.Resolved.Add(Specifier, OutScriptPath);
+		}
+		return bResolved;
+	}
+
+	bool ResolveModule(FString base_path, const FString& Specifier, FString& OutScriptPath)
+	{
+		for (;;)
+		{
+			if (!FJavascriptModuleResolver::DirectoryExists(base_path)) return false;
+
+			auto script_path = base_path / Specifier;
+			if (!script_path.EndsWith(TEXT(".js")))
+			{
+				if (ModuleExists(script_path + TEXT(".js"), OutScriptPath)) return true;
+				if (ModuleExists(script_path / TEXT("index.js"), OutScriptPath)) return true;
+
+				FString Main;
+				if (GetPackageMain(script_path, Main) && ModuleExists(script_path / Main, OutScriptPath)) return true;
+			}
+			else
+			{
+				if (ModuleExists(script_path, OutScriptPath)) return true;
+			}
+
+			base_path = base_path / TEXT("node_modules");
+		}
+	}
+
+	bool ModuleExists(const FString& script_path, FString& OutScriptPath)
+	{
+		if (Modules.Contains(script_path) || FindSnapshotModule(script_path) || FJavascriptModuleResolver::FileExists(script_path))
+		{
+			OutScriptPath = script_path;
+			return true;
+		}
+		return false;
+	}
+
+	// package.json is parsed natively, once per directory
+	bool GetPackageMain(const FString& Directory, FString& OutMain)
+	{
+		if (!FJavascriptModuleResolver::FindPackageMain(Directory, OutMain))
+		{
+			OutMain.Empty();
+
+			auto package_path = Directory / TEXT("package.json");
+
+			FString Text;
+			if (FJavascriptModuleResolver::FileExists(package_path) && FJavascriptScriptBundle::LoadFileToString(Text, package_path))
+			{
+				TryCatch try_catch;
+
+				Local<Value> json;
+				if (JSON::Parse(isolate(), V8_String(isolate(), Text)).ToLocal(&json) && json->IsObject())
+				{
+					auto main = json->ToObject()->Get(V8_KeywordString(isolate(), "main"));
+					if (main->IsString())
+					{
+						OutMain = StringFromV8(main);
+					}
+				}
+			}
+
+			FJavascriptModuleResolver::AddPackageMain(Directory, OutMain);
+		}
+
+		return !OutMain.IsEmpty();
+	}
+
+	// Module function compiled within startup snapshot?
+	UniquePersistent<Value>* FindSnapshotModule(const FString& script_path)
+	{
+		FString RelativePath;
+		if (SnapshotModules.Num() && GetScriptRelativePath(script_path, RelativePath))
+		{
+			return SnapshotModules.Find(RelativePath);
+		}
+		return nullptr;
+	}
+
+	static FString GetCallerDirectory(Isolate* isolate)
+	{
+		auto current_script_path = FPaths::GetPath(StringFromV8(StackTrace::CurrentStackTrace(isolate, 1, StackTrace::kScriptName)->GetFrame(0)->GetScriptName()));
+#if PLATFORM_WINDOWS
+		current_script_path = current_script_path.Replace(TEXT("\\"), TEXT("/"));
+#endif
+		return current_script_path;
+	}
+
+	/** Scripts being read/parsed on the thread pool (key : GetPendingLoadKey) */
+	TMap<FString, FAsyncScriptLoad*> PendingLoads;
+
+	// A file run as script and the same file required as module are different loads
+	static FString GetPendingLoadKey(const FString& Filename, FAsyncScriptLoad::EKind Kind)
+	{
+		return (Kind == FAsyncScriptLoad::EKind::Module ? TEXT("module:") : TEXT("file:")) + Filename;
+	}
+
+	Local<Promise> RejectedPromise(const FString& Message)
+	{
+		auto resolver = Promise::Resolver::New(context()).ToLocalChecked();
+		resolver->Reject(context(), Exception::Error(V8_String(isolate(), Message)));
+		return resolver->GetPromise();
+	}
+
+	Local<Promise> ResolvedPromise(Local<Value> Result)
+	{
+		auto resolver = Promise::Resolver::New(context()).ToLocalChecked();
+		resolver->Resolve(context(), Result.IsEmpty() ? Local<Value>(Undefined(isolate())) : Result);
+		return resolver->GetPromise();
+	}
+
+	Local<Promise> RequireAsync(const FString& script_path)
+	{
+		// Nothing to load
+		if (Modules.Contains(script_path) || FindSnapshotModule(script_path))
+		{
+			return ResolvedPromise(LoadModule(script_path));
+		}
+
+		return StartLoad(script_path, FAsyncScriptLoad::EKind::Module);
+	}
+
+	Local<Promise> RunFileAsync(const FString& Filename)
+	{
+		// Already run within startup snapshot
+		if (SnapshotScripts.Contains(Filename))
+		{
+			return ResolvedPromise(Undefined(isolate()));
+		}
+
+		return StartLoad(GetScriptFileFullPath(Filename), FAsyncScriptLoad::EKind::File);
+	}
+
+	// Joins the load of the same kind in flight if there is one
+	Local<Promise> StartLoad(const FString& Filename, FAsyncScriptLoad::EKind Kind)
+	{
+		const auto Key = GetPendingLoadKey(Filename, Kind);
+
+		if (auto Pending = PendingLoads.Find(Key))
+		{
+			return Local<Promise::Resolver>::New(isolate(), (*Pending)->Resolver)->GetPromise();
+		}
+
+		auto resolver = Promise::Resolver::New(context()).ToLocalChecked();
+
+		auto Load = new FAsyncScriptLoad;
+		Load->Kind = Kind;
+		Load->Filename = Filename;
+		Load->Resolver.Reset(isolate(), resolver);
+
+		// Parsed on the worker as well, if V8 can stream it (StreamedSource owns the stream)
+		Load->Stream = new FScriptSourceStream;
+		Load->Source = new ScriptCompiler::StreamedSource(Load->Stream, ScriptCompiler::StreamedSource::UTF8);
+		Load->StreamingTask = ScriptCompiler::StartStreamingScript(isolate(), Load->Source);
+		if (!Load->StreamingTask)
+		{
+			delete Load->Source;
+			Load->Source = nullptr;
+			Load->Stream = nullptr;
+		}
+
+		Load->Task = new FAsyncTask<FScriptLoadTask>(Load);
+		Load->Task->StartBackgroundTask();
+
+		PendingLoads.Add(Key, Load);
+
+		INC_DWORD_STAT(STAT_JavascriptAsyncLoads);
+
+		return resolver->GetPromise();
+	}
+
+	// Called every frame, isolate and context are entered already
+	void FinishLoads()
+	{
+		if (PendingLoads.Num() == 0) return;
+
+		// Finishing may start other loads
+		TArray<FAsyncScriptLoad*> Finished;
+		for (auto It = PendingLoads.CreateIterator(); It; ++It)
+		{
+			if (It.Value()->Task->IsDone())
+			{
+				Finished.Add(It.Value());
+				It.RemoveCurrent();
+			}
+		}
+
+		for (auto Load : Finished)
+		{
+			FinishLoad(Load);
+			delete Load;
+		}
+	}
+
+	void FinishLoad(FAsyncScriptLoad* Load)
+	{
+		HandleScope handle_scope(isolate());
+
+		auto resolver = Local<Promise::Resolver>::New(isolate(), Load->Resolver);
+
+		if (!Load->bLoaded)
+		{
+			resolver->Reject(context(), Exception::Error(V8_String(isolate(), FString::Printf(TEXT("Cannot load '%s'"), *Load->Filename))));
+			return;
+		}
+
+		const bool bModule = Load->Kind == FAsyncScriptLoad::EKind::Module;
+
+		// Required synchronously meanwhile
+		if (bModule && Modules.Contains(Load->Filename))
+		{
+			resolver->Resolve(context(), LoadModule(Load->Filename));
+			return;
+		}
+
+		auto full_path = GetFullPathForOrigin(Load->Filename);
+		const FString* Text = nullptr;
+		auto source = V8_ExternalString(isolate(), MoveTemp(Load->Text), Text);
+		ScriptOrigin origin(V8_String(isolate(), full_path), Integer::New(isolate(), bModule ? -2 : 0));
+
+		TryCatch try_catch;
+
+		Local<Script> script;
+		if (Load->Source)
+		{
+			ScriptCompiler::Compile(context(), Load->Source, source, origin).ToLocal(&script);
+
+			INC_DWORD_STAT(STAT_JavascriptStreamedCompilations);
+		}
+		else
+		{
+			FJavascriptCodeCache::Compile(context(), full_path, *Text, source, origin).ToLocal(&script);
+		}
+
+		Local<Value> result;
+		if (!script.IsEmpty())
+		{
+			result = script->Run();
+		}
+
+		if (try_catch.HasCaught())
+		{
+			auto exception = try_catch.Exception();
+			FV8Exception::Report(try_catch);
+			resolver->Reject(context(), exception);
+			return;
+		}
+
+		if (bModule)
+		{
+			result = InstantiateModule(Load->Filename, result);
+			if (result.IsEmpty())
+			{
+				resolver->Reject(context(), Exception::Error(V8_String(isolate(), FString::Printf(TEXT("Invalid module '%s'"), *Load->Filename))));
+				return;
+			}
+		}
+
+		resolver->Resolve(context(), result.IsEmpty() ? Local<Value>(Undefined(isolate())) : result);
+	}
+
+	void ReleasePendingLoads()
+	{
+		// Waits for workers
+		for (auto It = PendingLoads.CreateIterator(); It; ++It)
+		{
+			delete It.Value();
+		}
+		PendingLoads.Empty();
+	}
+
+	virtual void Public_RunFileAsync(const FString& Filename) override
+	{
+		Isolate::Scope isolate_scope(isolate());
+		HandleScope handle_scope(isolate());
+		Context::Scope context_scope(context());
+
+		RunFileAsync(Filename);
+	}
+
+	virtual void Preload(const TArray<FString>& Specifiers) override
+	{
+		Isolate::Scope isolate_scope(isolate());
+		HandleScope handle_scope(isolate());
+		Context::Scope context_scope(context());
+
+		for (const auto& Specifier : Specifiers)
+		{
+			FString ScriptPath;
+
+			bool bResolved = false;
+			for (int32 Index = 0; !bResolved && Index < Paths.Num(); ++Index)
+			{
+				bResolved = ResolveModule(Paths[Index], Specifier, ScriptPath);
+			}
+
+			if (bResolved)
+			{
+				RequireAsync(ScriptPath);
+			}
+			else
+			{
+				UE_LOG(Javascript, Warning, TEXT("Preload : cannot find module '%s'"), *Specifier);
+			}
+		}
+	}
+
+	virtual int32 GetNumPendingLoads() const override
+	{
+		return PendingLoads.Num();
+	}
+
+	Local<Value> LoadModule(const FString& script_path)
+	{
+		if (auto it = Modules.Find(script_path))
+		{
+			return Local<Value>::New(isolate(), *it);
+		}
+
+		if (auto snapshot_module = FindSnapshotModule(script_path))
+		{
+			return InstantiateModule(script_path, Local<Value>::New(isolate(), *snapshot_module));
+		}
+
+		FString Text;
+		if (!FJavascriptScriptBundle::LoadFileToString(Text, script_path))
+		{
+			return Undefined(isolate());
+		}
+
+		return InstantiateModule(script_path, RunScript(GetFullPathForOrigin(script_path), WrapModuleSource(Text), 2, true));
+	}
+
+	static FString GetFullPathForOrigin(const FString& script_path)
+	{
+		auto full_path = IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(*script_path);
+#if PLATFORM_WINDOWS
+		full_path = full_path.Replace(TEXT("/"), TEXT("\\"));
+#endif
+		return full_path;
+	}
+
+	// Runs module function (see WrapModuleSource) and registers its exports
+	Local<Value> InstantiateModule(const FString& script_path, Local<Value> module_function)
+	{
+		Local<Value> exports;
+
+		if (!module_function.IsEmpty() && module_function->IsFunction())
+		{
+			auto dirname = FPaths::GetPath(script_path);
+			auto& Record = GetModuleRecord(script_path);
+
+			auto module = Object::New(isolate());
+			module->Set(V8_KeywordString(isolate(), "exports"), Object::New(isolate()));
+			module->Set(V8_KeywordString(isolate(), "filename"), V8_String(isolate(), script_path));
+			module->Set(V8_KeywordString(isolate(), "hot"), CreateHotObject(Record));
+
+			// Handed over to this instance
+			Record.Data.Reset();
+
+			TryCatch try_catch;
+
+			Local<Value> argv[] = { V8_String(isolate(), dirname), V8_String(isolate(), script_path), GetRequireFunction(Record), module };
+			exports = Local<Function>::Cast(module_function)->Call(context()->Global(), 4, argv);
+
+			if (try_catch.HasCaught())
+			{
+				FV8Exception::Report(try_catch);
+				exports = Local<Value>();
+			}
+		}
+
+		if (exports.IsEmpty())
+		{
+			UE_LOG(Javascript, Log, TEXT("Invalid script for require"));
+		}
+		Modules.Add(script_path, UniquePersistent<Value>(isolate(), exports));
+		return exports;
+	}
+
+	void ExposeRequire()
+	{
+		// Global require, for scripts which aren't modules
+		auto fn = [](const FunctionCallbackInfo<Value>& info) {
+			auto isolate = info.GetIsolate();
+			HandleScope scope(isolate);
+
+			if (info.Length() != 1 || !(info[0]->IsString()))
+			{
+				return;
+			}
+
+			auto Self = reinterpret_cast<FJavascriptContextImplementation*>((Local<External>::Cast(info.Data()))->Value());
+
+			auto exports = Self->Require(Self->GetRequireDirectory(GetCallerDirectory(isolate)), StringFromV8(info[0]));
+			info.GetReturnValue().Set(exports.IsEmpty() ? Local<Value>(Undefined(isolate)) : exports);
+		};
+
+		// requireAsync(module) : Promise of exports
+		auto fn_async = [](const FunctionCallbackInfo<Value>& info) {
+			auto isolate = info.GetIsolate();
+
+			if (info.Length() != 1 || !(info[0]->IsString()))
+			{
+				return;
+			}
+
+			auto Self = reinterpret_cast<FJavascriptContextImplementation*>((Local<External>::Cast(info.Data()))->Value());
+
+			auto Specifier = StringFromV8(info[0]);
+
+			FString ScriptPath;
+			if (!Self->Resolve(Self->GetRequireDirectory(GetCallerDirectory(isolate)), Specifier, ScriptPath))
+			{
+				info.GetReturnValue().Set(Self->RejectedPromise(FString::Printf(TEXT("Cannot find module '%s'"), *Specifier)));
+				return;
+			}
+
+			info.GetReturnValue().Set(Self->RequireAsync(ScriptPath));
+		};
+
+		// runFileAsync(filename) : Promise of completion value
+		auto fn_run_async = [](const FunctionCallbackInfo<Value>& info) {
+			if (info.Length() != 1 || !(info[0]->IsString()))
+			{
+				return;
+			}
+
+			auto Self = reinterpret_cast<FJavascriptContextImplementation*>((Local<External>::Cast(info.Data()))->Value());
+
+			info.GetReturnValue().Set(Self->RunFileAsync(StringFromV8(info[0])));
+		};
+
+		// purge_modules() : all modules, purge_modules([files]) : modules of changed files and their dependents
+		auto fn2 = [](const FunctionCallbackInfo<Value>& info) {
+			auto isolate = info.GetIsolate();
+			HandleScope scope(isolate);
+
+			auto Self = reinterpret_cast<FJavascriptContextImplementation*>((Local<External>::Cast(info.Data()))->Value());
+
+			if (info.Length() == 1 && info[0]->IsArray())
+			{
+				TArray<FString> Files;
+
+				auto arr = Local<Array>::Cast(info[0]);
+				for (uint32_t Index = 0; Index < arr->Length(); ++Index)
+				{
+					Files.Add(StringFromV8(arr->Get(Index)));
+				}
+
+				info.GetReturnValue().Set(Self->InvalidateModules(Files));
+				return;
+			}
+
+			// Dispose handlers may require, which adds records
+			TArray<FModuleRecord*> Loaded;
+			for (auto It = Self->ModuleRecords.CreateConstIterator(); It; ++It)
+			{
+				if (Self->Modules.Contains(It.Key()))
+				{
+					Loaded.Add(It.Value());
+				}
+			}
+
+			for (auto Record : Loaded)
+			{
+				Self->DisposeModule(*Record);
+			}
+			Self->PurgeModules();
+		};
+
+		auto global = context()->Global();
+		auto self = External::New(isolate(), this);
+
+		global->Set(V8_KeywordString(isolate(), "require"), FunctionTemplate::New(isolate(), fn, self)->GetFunction());
+		global->Set(V8_KeywordString(isolate(), "purge_modules"), FunctionTemplate::New(isolate(), fn2, self)->GetFunction());
+		global->Set(V8_KeywordString(isolate(), "requireAsync"), FunctionTemplate::New(isolate(), fn_async, self)->GetFunction());
+		global->Set(V8_KeywordString(isolate(), "runFileAsync"), FunctionTemplate::New(isolate(), fn_run_async, self)->GetFunction());
+
+		auto getter = [](Local<String> property, const PropertyCallbackInfo<Value>& info) {
+			auto isolate = info.GetIsolate();
+			HandleScope scope(isolate);
+
+			auto Self = reinterpret_cast<FJavascriptContextImplementation*>((Local<External>::Cast(info.Data()))->Value());
+
+			auto out = Object::New(isolate);
+
+			for (auto it = Self->Modules.CreateConstIterator(); it; ++it)
+			{
+				const auto& name = it.Key();
+				const auto& module = it.Value();
+
+				auto FullPath = IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(*name);
+				out->Set(V8_String(isolate, name), V8_String(isolate, FullPath));
+			}
+
+			info.GetReturnValue().Set(out);
+		};
+		global->SetAccessor(V8_KeywordString(isolate(), "modules"), getter, 0, self);
+	}
+
+	FString GetScriptFileFullPath(const FString& Filename)
+	{
+		for (auto Path : Paths)
+		{
+			auto FullPath = Path / Filename;
+			if (FJavascriptModuleResolver::FileExists(FullPath))
+			{
+				return IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(*FullPath);
+			}
+		}
+		return Filename;
+	}
+
+	FString ReadScriptFile(const FString& Filename)
+	{
+		auto Path = GetScriptFileFullPath(Filename);
+
+		FString Text;
+
+		FJavascriptScriptBundle::LoadFileToString(Text, Path);
+
+		return Text;
+	}
+
+	Local<Value> RunFile(const FString& Filename)
+	{
+		HandleScope handle_scope(isolate());
+
+		auto Script = ReadScriptFile(Filename);
+
+		return RunScript(GetScriptFileFullPath(Filename), MoveTemp(Script), 0, true);
+	}
+
+	void Public_RunFile(const FString& Filename)
+	{
+		// Already run within startup snapshot
+		if (SnapshotScripts.Contains(Filename)) return;
+
+		RunFile(Filename);
+	}
+
+	FString Public_RunScript(const FString& Script, bool bOutput = true)
+	{
+		Isolate::Scope isolate_scope(isolate());
+		HandleScope handle_scope(isolate());
+		Context::Scope context_scope(context());
+
+		auto ret = RunScript(TEXT("(inline)"), Script);
+		auto str = ret.IsEmpty() ? TEXT("(empty)") : StringFromV8(ret);
+
+		if (bOutput && !ret.IsEmpty())
+		{
+			UE_LOG(Javascript, Log, TEXT("%s"), *str);
+		}		
+		return str;
+	}
+
+	// Should be guarded with proper handle scope
+	Local<Value> RunScript(const FString& Filename, const FString& Script, int line_offset = 0, bool bFromFile = false)
+	{
+		Isolate::Scope isolate_scope(isolate());
+
+		return RunScript(Filename, V8_String(isolate(), Script), Script, line_offset, bFromFile);
+	}
+
+	// Script is taken over, long sources are handed to V8 without copying
+	Local<Value> RunScript(const FString& Filename, FString&& Script, int line_offset = 0, bool bFromFile = false)
+	{
+		Isolate::Scope isolate_scope(isolate());
+
+		const FString* Text = nullptr;
+		auto source = V8_ExternalString(isolate(), MoveTemp(Script), Text);
+		return RunScript(Filename, source, *Text, line_offset, bFromFile);
+	}
+
+	Local<Value> RunScript(const FString& Filename, Local<String> source, const FString& Script, int line_offset, bool bFromFile)
+	{
+		Isolate::Scope isolate_scope(isolate());
+		Context::Scope context_scope(context());
+
+		TryCatch try_catch;
+		try_catch.SetVerbose(true);
+
+		auto Path = Filename;
+		auto path = V8_String(isolate(), Path);
+		ScriptOrigin origin(path, Integer::New(isolate(), -line_offset));
+
+		Local<v8::Script> script;
+		if (bFromFile)
+		{
+			// Scripts from file go through code cache
+			FJavascriptCodeCache::Compile(context(), Filename, Script, source, origin).ToLocal(&script);
+		}
+		else
+		{
+			script = Script::Compile(source, &origin);
+		}
+
+		if (script.IsEmpty())
+		{
+			FV8Exception::Report(try_catch);
+			return Local<Value>();
+		}
+
+		auto result = script->Run();
+		if (try_catch.HasCaught())
+		{
+			FV8Exception::Report(try_catch);
+			return Local<Value>();
+		}
+		else
+		{
+			return result;
+		}
+	}
+
+	void Expose(FString RootName, UObject* Object)
+	{
+		WKOs.Add(RootName, Object);
+
+		auto RootGetter = [](Local<String> property, const PropertyCallbackInfo<Value>& info) {
+			auto isolate = info.GetIsolate();
+			info.GetReturnValue().Set(info.Data());
+		};
+
+		Isolate::Scope isolate_scope(isolate());
+		HandleScope handle_scope(isolate());
 		Context::Scope context_scope(context());
 
 		context()->Global()->SetAccessor(V8_KeywordString(isolate(), RootName), RootGetter, 0, ExportObject(Object));
@@ -1070,6 +1995,9 @@ public:
 
 		TokenWriter w;
 
+		// Lazily exported isolate may not have exported everything yet
+		Environment->ExportAll();
+
 		for (auto it = Environment->ClassToFunctionTemplateMap.CreateConstIterator(); it; ++it)
 		{
 			const UClass* ClassToExport = it.Key();
@@ -1133,6 +2061,9 @@ public:
 
 		instance.ExportBootstrap();
 
+		// Lazily exported isolate may not have exported everything yet
+		Environment->ExportAll();
+
 		for (auto it = Environment->ClassToFunctionTemplateMap.CreateConstIterator(); it; ++it)
 		{
 			instance.Export(it.Key());
@@ -1154,8 +2085,13 @@ public:
 #endif
 	}
 
-	Local<Value> GetProxyFunction(UObject* Object, const TCHAR* Name)
+	Local<Value> GetProxyFunction(UObject* Object, Local<String> Name)
 	{
+		if (!Object)
+		{
+			return Undefined(isolate());
+		}
+
 		auto v8_obj = ExportObject(Object)->ToObject();
 		auto proxy = v8_obj->Get(V8_KeywordString(isolate(), "proxy"));
 		if (proxy.IsEmpty() || !proxy->IsObject())
@@ -1163,7 +2099,7 @@ public:
 			return Undefined(isolate());
 		}
 
-		auto func = proxy->ToObject()->Get(V8_KeywordString(isolate(), Name));
+		auto func = proxy->ToObject()->Get(Name);
 		if (func.IsEmpty() || !func->IsFunction())
 		{
 			return Undefined(isolate());
@@ -1174,7 +2110,41 @@ public:
 
 	Local<Value> GetProxyFunction(UObject* Object, UFunction* Function)
 	{
-		return GetProxyFunction(Object, *FV8Config::Safeify(Function->GetName()));
+		if (auto Functions = ProxyFunctionCache.Find(Object))
+		{
+			if (auto Cached = Functions->Find(Function))
+			{
+				if (!Cached->IsValid())
+				{
+					INC_DWORD_STAT(STAT_JavascriptProxyFunctionHits);
+					return Undefined(isolate());
+				}
+				else if (!(*Cached)->IsEmpty())
+				{
+					INC_DWORD_STAT(STAT_JavascriptProxyFunctionHits);
+					return Local<Function>::New(isolate(), **Cached);
+				}
+			}
+		}
+
+		INC_DWORD_STAT(STAT_JavascriptProxyFunctionMisses);
+
+		// V8 may run weak callbacks (and invalidate entries) while resolving, so look the map up again afterwards
+		auto func = GetProxyFunction(Object, Function ? V8_KeywordString(isolate(), FV8Config::Safeify(Function->GetName())) : V8_KeywordString(isolate(), "ctor"));
+
+		TSharedPtr< UniquePersistent<Function> > Entry;
+		if (func->IsFunction())
+		{
+			// Weak, so that a proxy function capturing its holder doesn't keep the holder alive
+			Entry = MakeShareable(new UniquePersistent<Function>(isolate(), Local<Function>::Cast(func)));
+			Entry->SetWeak(Entry.Get(), [](const WeakCallbackInfo< UniquePersistent<Function> >& data) {
+				data.GetParameter()->Reset();
+			}, WeakCallbackType::kParameter);
+		}
+
+		ProxyFunctionCache.FindOrAdd(Object).Add(Function, Entry);
+
+		return func;
 	}
 
 	bool HasProxyFunction(UObject* Holder, UFunction* Function)
@@ -1206,11 +2176,91 @@ public:
 		}
 	}
 
+	// (listeners, deltas) => errors : listeners[i] is called with deltas[i], a throwing listener doesn't stop the others
+	Local<Function> GetTickDispatcher()
+	{
+		if (TickDispatcher.IsEmpty())
+		{
+			auto Source = TEXT(
+				"(function (listeners, deltas) {"
+				"  var errors;"
+				"  for (var i = 0; i < listeners.length; ++i) {"
+				"    try { listeners[i](deltas[i]) } catch (e) { (errors || (errors = [])).push(e) }"
+				"  }"
+				"  return errors"
+				"})");
+
+			auto func = RunScript(TEXT("(tick dispatcher)"), Source);
+			if (func.IsEmpty() || !func->IsFunction())
+			{
+				return Local<Function>();
+			}
+
+			TickDispatcher.Reset(isolate(), Local<Function>::Cast(func));
+		}
+
+		return Local<Function>::New(isolate(), TickDispatcher);
+	}
+
+	virtual void DispatchTicks(const TArray<UJavascriptComponent*>& Components, const TArray<float>& DeltaTimes) override
+	{
+		HandleScope handle_scope(isolate());
+		Context::Scope context_scope(context());
+
+		auto listeners = Array::New(isolate());
+		auto deltas = Array::New(isolate());
+		int32 NumListeners = 0;
+
+		for (int32 Index = 0; Index < Components.Num(); ++Index)
+		{
+			auto Component = Components[Index];
+
+			// Bound by script through delegate proxy, otherwise fire it as usual
+			auto Dispatcher = Cast<UJavascriptDelegate>(Component->OnTick.GetUObject());
+			if (!Dispatcher)
+			{
+				Component->OnTick.ExecuteIfBound(DeltaTimes[Index]);
+				continue;
+			}
+
+			auto Num = IDelegateManager::CollectListeners(isolate(), Dispatcher, listeners, NumListeners);
+			for (int32 Listener = 0; Listener < Num; ++Listener)
+			{
+				deltas->Set(NumListeners++, Number::New(isolate(), DeltaTimes[Index]));
+			}
+		}
+
+		if (NumListeners == 0) return;
+
+		auto func = GetTickDispatcher();
+		if (func.IsEmpty()) return;
+
+		FTypedArrayViews::ValidateViews(isolate());
+
+		TryCatch try_catch;
+
+		Local<Value> argv[] = { listeners, deltas };
+		auto errors = func->Call(context()->Global(), 2, argv);
+
+		if (try_catch.HasCaught())
+		{
+			FV8Exception::Report(try_catch);
+		}
+		else if (!errors.IsEmpty() && errors->IsArray())
+		{
+			auto arr = Local<Array>::Cast(errors);
+			for (uint32_t Index = 0; Index < arr->Length(); ++Index)
+			{
+				auto error = arr->Get(Index);
+				auto stack = error->IsObject() ? error->ToObject()->Get(V8_KeywordString(isolate(), "stack")) : Local<Value>();
+				UE_LOG(Javascript, Error, TEXT("Exception in tick : %s"), *StringFromV8(!stack.IsEmpty() && stack->IsString() ? stack : error));
+			}
+		}
+	}
+
 	// To tell Unreal engine's GC not to destroy these objects!
 	virtual void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector) override
 	{		
-		Public_RunScript(TEXT("gc();"), false);
-
 		// All objects
 		for (auto It = ObjectToObjectMap.CreateIterator(); It; ++It)
 		{
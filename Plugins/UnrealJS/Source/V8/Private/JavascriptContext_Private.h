@@ -1,8 +1,23 @@
 #pragma once
 
+class UJavascriptComponent;
+
+/** FastCall frame (UJavascriptContext::InternalBegin..InternalEnd), kept around so that nested calls don't allocate */
+struct FJavascriptCallFrame
+{
+	enum { MaxArgs = 32 };
+
+	TTypeCompatibleBytes<v8::HandleScope> HandleScope;
+
+	v8::Local<v8::Value> Argv[MaxArgs];
+	int32 Argc;
+
+	v8::Local<v8::Value> ReturnValue;
+};
+
 struct FJavascriptContext : TSharedFromThis<FJavascriptContext>
 {
-	FJavascriptContext(TSharedPtr<FJavascriptIsolate> InEnvironment) : Environment(InEnvironment) {}
+	FJavascriptContext(TSharedPtr<FJavascriptIsolate> InEnvironment) : Environment(InEnvironment), CallDepth(0), ProxyGeneration(0), AllProxiesGeneration(0), LastFunctionHandleId(0) {}
 
 	/** Isolate **/
 	TSharedPtr<FJavascriptIsolate> Environment;
@@ -13,12 +28,73 @@ struct FJavascriptContext : TSharedFromThis<FJavascriptContext>
 	/** A map from Struct buffer to V8 Object */
 	TMap< TSharedPtr<FStructMemoryInstance>, v8::UniquePersistent<v8::Value> > MemoryToObjectMap;
 
+	/** FastCall frames, CallDepth of them are in use */
+	TIndirectArray<FJavascriptCallFrame> CallFrames;
+	int32 CallDepth;
+
+	/**
+	 * Proxy functions resolved per holder object and UFunction (nullptr : proxy.ctor).
+	 * An invalid pointer means script doesn't implement the function; an empty handle means it has been collected and needs resolving again.
+	 * Entries are resolved once per proxy object : functions added to or replaced in a proxy afterwards are seen
+	 * only once the holder's proxy is assigned again (even the same object), which calls InvalidateProxyFunctions.
+	 */
+	TMap< UObject*, TMap< UFunction*, TSharedPtr< v8::UniquePersistent<v8::Function> > > > ProxyFunctionCache;
+
+	/**
+	 * FJavascriptFunctionHandle stamps the function it resolves with ProxyGeneration, and resolves again once
+	 * its holder's proxy (HolderProxyGenerations) or all proxies (AllProxiesGeneration) have changed after that.
+	 * Only holders which have been assigned a proxy are tracked, so collecting other wrappers costs nothing.
+	 */
+	uint32 ProxyGeneration;
+	uint32 AllProxiesGeneration;
+	TMap<UObject*, uint32> HolderProxyGenerations;
+
+	uint32 GetProxyGeneration(UObject* Holder) const
+	{
+		return FMath::Max(AllProxiesGeneration, HolderProxyGenerations.FindRef(Holder));
+	}
+
+	/** Called when holder's proxy has been reassigned */
+	void InvalidateProxyFunctions(UObject* Holder)
+	{
+		ProxyFunctionCache.Remove(Holder);
+		HolderProxyGenerations.Add(Holder, ++ProxyGeneration);
+	}
+
+	/** Called when holder's wrapper has been collected, its proxy (if any) has gone with it */
+	void ForgetProxyFunctions(UObject* Holder)
+	{
+		ProxyFunctionCache.Remove(Holder);
+		if (auto Generation = HolderProxyGenerations.Find(Holder))
+		{
+			*Generation = ++ProxyGeneration;
+		}
+	}
+
+	/** Called when modules (which define most proxies) have been purged or reloaded */
+	void InvalidateAllProxyFunctions()
+	{
+		ProxyFunctionCache.Empty();
+		HolderProxyGenerations.Empty();
+		AllProxiesGeneration = ++ProxyGeneration;
+	}
+
+	/** Functions resolved by FJavascriptFunctionHandle */
+	TMap< int32, v8::UniquePersistent<v8::Function> > FunctionHandles;
+	int32 LastFunctionHandleId;
+
+	/** Script function which calls tick listeners of all batched components (see DispatchTicks) */
+	v8::UniquePersistent<v8::Function> TickDispatcher;
+
 	virtual ~FJavascriptContext() {}
 	virtual void Expose(FString RootName, UObject* Object) = 0;
 	virtual FString GetScriptFileFullPath(const FString& Filename) = 0;
 	virtual FString ReadScriptFile(const FString& Filename) = 0;
 	virtual FString Public_RunScript(const FString& Script, bool bOutput = true) = 0;
 	virtual void Public_RunFile(const FString& Filename) = 0;
+	virtual void Public_RunFileAsync(const FString& Filename) = 0;
+	virtual void Preload(const TArray<FString>& Specifiers) = 0;
+	virtual int32 GetNumPendingLoads() const = 0;
 	virtual void SetAsDebugContext() = 0;
 	virtual bool IsDebugContext() const = 0;
 	virtual bool WriteAliases(const FString& Filename) = 0;
@@ -29,7 +105,7 @@ struct FJavascriptContext : TSharedFromThis<FJavascriptContext>
 	virtual v8::Isolate* isolate() = 0;
 	virtual v8::Local<v8::Context> context() = 0;
 	virtual v8::Local<v8::Value> ExportObject(UObject* Object, bool bForce = false) = 0;
-	virtual v8::Local<v8::Value> GetProxyFunction(UObject* Object, const TCHAR* Name) = 0;
+	virtual v8::Local<v8::Value> GetProxyFunction(UObject* Object, v8::Local<v8::String> Name) = 0;
 
 	static FJavascriptContext* FromV8(v8::Local<v8::Context> Context);
 
@@ -37,5 +113,8 @@ struct FJavascriptContext : TSharedFromThis<FJavascriptContext>
 
 	virtual void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector) = 0;
 
+	/** Calls OnTick listeners of components with a single call into script, isolate should be entered already */
+	virtual void DispatchTicks(const TArray<UJavascriptComponent*>& Components, const TArray<float>& DeltaTimes) = 0;
+
 	virtual const FObjectInitializer* GetObjectInitializer() = 0;
 };
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include "V8PCH.h"
+#include "JavascriptIsolatePool.h"
+#include "JavascriptIsolate.h"
+#include "JavascriptSettings.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled isolates"), STAT_JavascriptPooledIsolates, STATGROUP_Javascript);
+
+namespace
+{
+	struct FPooledIsolate
+	{
+		TWeakObjectPtr<UJavascriptIsolate> Isolate;
+		int32 NumContexts;
+	};
+
+	// World -> isolates (null world for global sharing)
+	TMap<TWeakObjectPtr<UWorld>, TArray<FPooledIsolate>> Pools;
+}
+
+UJavascriptIsolate* FJavascriptIsolatePool::Acquire(UWorld* World)
+{
+	auto Settings = GetDefault<UJavascriptSettings>();
+
+	if (Settings->ComponentIsolateSharing == EJavascriptIsolateSharing::PerComponent)
+	{
+		return NewObject<UJavascriptIsolate>();
+	}
+
+	auto& Pool = Pools.FindOrAdd(Settings->ComponentIsolateSharing == EJavascriptIsolateSharing::PerWorld ? World : nullptr);
+
+	Pool.RemoveAll([](const FPooledIsolate& Pooled) { return !Pooled.Isolate.IsValid(); });
+
+	// Pick the least loaded one
+	FPooledIsolate* Best = nullptr;
+	for (auto& Pooled : Pool)
+	{
+		if (!Best || Pooled.NumContexts < Best->NumContexts)
+		{
+			Best = &Pooled;
+		}
+	}
+
+	if (!Best || (Best->NumContexts > 0 && Pool.Num() < FMath::Max(Settings->MaxIsolatesPerPool, 1)))
+	{
+		FPooledIsolate Pooled;
+		Pooled.Isolate = NewObject<UJavascriptIsolate>();
+		Pooled.NumContexts = 0;
+		Best = &Pool[Pool.Add(Pooled)];
+
+		INC_DWORD_STAT(STAT_JavascriptPooledIsolates);
+	}
+
+	Best->NumContexts++;
+
+	return Best->Isolate.Get();
+}
+
+void FJavascriptIsolatePool::Release(UJavascriptIsolate* Isolate)
+{
+	for (auto It = Pools.CreateIterator(); It; ++It)
+	{
+		auto& Pool = It.Value();
+
+		for (int32 Index = 0; Index < Pool.Num(); ++Index)
+		{
+			auto& Pooled = Pool[Index];
+			if (Pooled.Isolate.Get() == Isolate)
+			{
+				// The last context has gone, so does the isolate.
+				if (--Pooled.NumContexts <= 0)
+				{
+					Pool.RemoveAt(Index);
+
+					DEC_DWORD_STAT(STAT_JavascriptPooledIsolates);
+				}
+
+				if (Pool.Num() == 0)
+				{
+					It.RemoveCurrent();
+				}
+				return;
+			}
+		}
+	}
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+class UJavascriptIsolate;
+
+/**
+ * Isolates shared among UJavascriptComponents (see UJavascriptSettings::ComponentIsolateSharing)
+ * Pooled isolates are reference-counted by their contexts. When the last context is released, 
+ * the isolate leaves the pool and is collected along with its contexts.
+ */
+struct FJavascriptIsolatePool
+{
+	static UJavascriptIsolate* Acquire(UWorld* World);
+	static void Release(UJavascriptIsolate* Isolate);
+};
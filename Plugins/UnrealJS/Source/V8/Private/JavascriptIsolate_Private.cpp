@@ -1,6 +1,6 @@
 #include "V8PCH.h"
 #include "Config.h"
-#include "MallocArrayBufferAllocator.h"
+#include "PooledArrayBufferAllocator.h"
 #include "Translator.h"
 #include "ScopedArguments.h"
 #include "Exception.h"
@@ -8,11 +8,28 @@
 #include "JavascriptIsolate_Private.h"
 #include "JavascriptContext_Private.h"
 #include "JavascriptContext.h"
+#include "JavascriptIsolate.h"
 #include "Helpers.h"
 #include "JavascriptGeneratedClass.h"
+#include "JavascriptSettings.h"
+#include "JavascriptSnapshot.h"
+#include "StringCache.h"
+#include "TypedArrays.h"
+#include "LazyArray.h"
+#include "GCScheduler.h"
+#if WITH_EDITOR
+#include "IHotReload.h"
+#endif
 
 using namespace v8;
 
+DECLARE_CYCLE_STAT(TEXT("Initialize global template"), STAT_JavascriptInitializeGlobalTemplate, STATGROUP_Javascript);
+DECLARE_CYCLE_STAT(TEXT("Export on demand"), STAT_JavascriptExportOnDemand, STATGROUP_Javascript);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Call plan hits"), STAT_JavascriptCallPlanHits, STATGROUP_Javascript);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Call plan misses"), STAT_JavascriptCallPlanMisses, STATGROUP_Javascript);
+DEFINE_STAT(STAT_JavascriptArrayBufferPoolHits);
+DEFINE_STAT(STAT_JavascriptArrayBufferPoolMisses);
+
 #include "StructMemoryInstance.h"
 
 template <typename CppType>
@@ -27,21 +44,24 @@ struct TStructReader
 	bool Read(Isolate* isolate, Local<Value> Value, CppType& Target) const;
 };
 
-static v8::ArrayBuffer::Contents GCurrentContents;
-
-int32 FArrayBufferAccessor::GetSize()
-{
-	return GCurrentContents.ByteLength();
-}
-
-void* FArrayBufferAccessor::GetData()
-{
-	return GCurrentContents.Data();
-}
-
-void FArrayBufferAccessor::Discard()
+// ArrayBuffer or typed array, without externalizing it
+static FJavascriptBuffer BufferFromV8(Local<Value> Value)
 {
-	GCurrentContents = v8::ArrayBuffer::Contents();
+	if (Value->IsArrayBuffer())
+	{
+		auto Contents = Value.As<ArrayBuffer>()->GetContents();
+		return FJavascriptBuffer(Contents.Data(), Contents.ByteLength());
+	}
+	else if (Value->IsArrayBufferView())
+	{
+		auto View = Value.As<ArrayBufferView>();
+		auto Contents = View->Buffer()->GetContents();
+		return FJavascriptBuffer((uint8*)Contents.Data() + View->ByteOffset(), View->ByteLength());
+	}
+	else
+	{
+		return FJavascriptBuffer();
+	}
 }
 
 class FJavascriptIsolateImplementation : public FJavascriptIsolate
@@ -55,10 +75,51 @@ public:
 	Persistent<ObjectTemplate> GlobalTemplate;
 
 	// Allocator instance should be set for V8's ArrayBuffer's
-	FMallocArrayBufferAllocator AllocatorInstance;	
+	FPooledArrayBufferAllocator AllocatorInstance;
+
+	// Buffer bound by memory.bind (FArrayBufferAccessor)
+	UniquePersistent<Value> BoundBuffer;
 
 	IDelegateManager* Delegates;
 
+	// Interned keys (isolate data slot 1)
+	FJavascriptStringCache* StringCache;
+
+	// Idle-time garbage collection (isolate data slot 2)
+	FJavascriptGCScheduler* GCScheduler;
+
+	// Live typed array views over TArray memory
+	FTypedArrayViews* TypedArrayViews;
+
+	// Resolved typed array mode per property
+	TMap<UArrayProperty*, EJavascriptTypedArrayMode::Type> TypedArrayModes;
+
+	// Set by memory.view()/memory.copy() for the duration of its callback (-1 : not forced)
+	int32 ForcedTypedArrayMode;
+
+	FDelegateHandle OnEndFrameHandle;
+
+	// Arrays of objects/structs which are wrapped on access
+	UniquePersistent<FunctionTemplate> LazyArrayTemplate;
+	TSet<FLazyArray*> LazyArrays;
+	int32 LazyArrayThreshold;
+
+	// Export classes/structs on first access instead of at isolate creation
+	bool bLazyExport;
+
+	// Created from startup snapshot
+	bool bUsingSnapshot;
+
+	// Flattened parameter layouts of functions called from Javascript
+	TMap<UFunction*, TSharedPtr<FJavascriptCallPlan>> CallPlans;
+
+	// Global names which resolve to neither a class nor a struct (eg. 'window' probed by polyfills)
+	TSet<FString> UnresolvedExports;
+
+#if WITH_EDITOR
+	FDelegateHandle OnHotReloadHandle;
+#endif
+
 	struct FObjectPropertyAccessors
 	{
 		static Local<Value> Get(Isolate* isolate, Local<Object> self, UProperty* Property)
@@ -155,6 +216,12 @@ public:
 				}				
 			}
 		}
+
+		static uint8* GetBuffer(Local<Object> self)
+		{
+			auto Object = UObjectFromV8(self);
+			return IsValid(Object) ? (uint8*)Object : nullptr;
+		}
 	};
 
 	struct FStructPropertyAccessors
@@ -170,6 +237,113 @@ public:
 			auto Instance = FStructMemoryInstance::FromV8(self);
 			WriteProperty(isolate, Property, Instance->GetMemory(), value);
 		}
+
+		static uint8* GetBuffer(Local<Object> self)
+		{
+			auto Instance = FStructMemoryInstance::FromV8(self);
+			return Instance ? Instance->GetMemory() : nullptr;
+		}
+	};
+
+	// Baked into accessor callback data of typed properties
+	struct FPropertyAccessorData
+	{
+		UProperty* Property;
+		int32 Offset;
+	};
+
+	// Accessor data lives as long as the templates which refer to it
+	TIndirectArray<FPropertyAccessorData> PropertyAccessorData;
+
+	struct FIntPropertyThunk
+	{
+		typedef int32 CppType;
+
+		static CppType Read(const FPropertyAccessorData& Data, uint8* Buffer)
+		{
+			return *(int32*)(Buffer + Data.Offset);
+		}
+
+		static void Write(const FPropertyAccessorData& Data, uint8* Buffer, Local<Value> value)
+		{
+			*(int32*)(Buffer + Data.Offset) = value->Int32Value();
+		}
+
+		static Local<Value> Box(Isolate* isolate, CppType Value)
+		{
+			return Int32::New(isolate, Value);
+		}
+	};
+
+	struct FFloatPropertyThunk
+	{
+		typedef double CppType;
+
+		static CppType Read(const FPropertyAccessorData& Data, uint8* Buffer)
+		{
+			return *(float*)(Buffer + Data.Offset);
+		}
+
+		static void Write(const FPropertyAccessorData& Data, uint8* Buffer, Local<Value> value)
+		{
+			*(float*)(Buffer + Data.Offset) = value->NumberValue();
+		}
+
+		static Local<Value> Box(Isolate* isolate, CppType Value)
+		{
+			return Number::New(isolate, Value);
+		}
+	};
+
+	struct FBoolPropertyThunk
+	{
+		typedef bool CppType;
+
+		static CppType Read(const FPropertyAccessorData& Data, uint8* Buffer)
+		{
+			return static_cast<UBoolProperty*>(Data.Property)->GetPropertyValue(Buffer + Data.Offset);
+		}
+
+		static void Write(const FPropertyAccessorData& Data, uint8* Buffer, Local<Value> value)
+		{
+			static_cast<UBoolProperty*>(Data.Property)->SetPropertyValue(Buffer + Data.Offset, value->BooleanValue());
+		}
+
+		static Local<Value> Box(Isolate* isolate, CppType Value)
+		{
+			return Boolean::New(isolate, Value);
+		}
+	};
+
+	template <typename PropertyAccessors, typename Thunk>
+	struct TTypedPropertyAccessors
+	{
+		static void Getter(Local<String> property, const PropertyCallbackInfo<Value>& info)
+		{
+			auto Data = reinterpret_cast<FPropertyAccessorData*>((Local<External>::Cast(info.Data()))->Value());
+			auto Buffer = PropertyAccessors::GetBuffer(info.This());
+
+			if (Buffer)
+			{
+				// ReturnValue boxes primitives without any intermediate handle
+				info.GetReturnValue().Set(Thunk::Read(*Data, Buffer));
+			}
+			else
+			{
+				info.GetReturnValue().SetUndefined();
+			}
+		}
+
+		static void Setter(Local<String> property, Local<Value> value, const PropertyCallbackInfo<void>& info)
+		{
+			auto Data = reinterpret_cast<FPropertyAccessorData*>((Local<External>::Cast(info.Data()))->Value());
+			auto Buffer = PropertyAccessors::GetBuffer(info.This());
+
+			if (Buffer && !value->IsUndefined())
+			{
+				Thunk::Write(*Data, Buffer, value);
+			}
+		}
 	};
 
 	void RegisterSelf(Isolate* isolate)
@@ -177,26 +351,86 @@ public:
 		isolate_ = isolate;
 		isolate->SetData(0, this);
 
+		// Microtasks are drained explicitly (see FJavascriptTimers)
+		isolate->SetAutorunMicrotasks(false);
+
+		StringCache = new FJavascriptStringCache(isolate);
+
+		TypedArrayViews = new FTypedArrayViews(isolate);
+
+		GCScheduler = new FJavascriptGCScheduler(isolate);
+
 		Delegates = IDelegateManager::Create(isolate);
 	}		
 
 	FJavascriptIsolateImplementation()
 	{
+		bLazyExport = GetDefault<UJavascriptSettings>()->bLazyExport;
+		ForcedTypedArrayMode = -1;
+		LazyArrayThreshold = GetDefault<UJavascriptSettings>()->LazyArrayThreshold;
+
 		Isolate::CreateParams params;
 
 		// Set our array buffer allocator instance
+		AllocatorInstance.SetMaxBytesHeld(GetDefault<UJavascriptSettings>()->ArrayBufferPoolSizeKB * 1024);
 		params.array_buffer_allocator = &AllocatorInstance;
 
+		// Deserialize from startup snapshot if we have one
+		params.snapshot_blob = FJavascriptSnapshot::Get();
+		bUsingSnapshot = params.snapshot_blob != nullptr;
+
 		// Bind this instance to newly created V8 isolate
 		RegisterSelf(Isolate::New(params));
 
 		GenerateBlueprintFunctionLibraryMapping();
 
 		InitializeGlobalTemplate();
+
+		OnEndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FJavascriptIsolateImplementation::OnEndFrame);
+
+#if WITH_EDITOR
+		// Functions may have changed their layout
+		if (auto HotReload = FModuleManager::GetModulePtr<IHotReloadInterface>("HotReload"))
+		{
+			OnHotReloadHandle = HotReload->OnHotReload().AddRaw(this, &FJavascriptIsolateImplementation::OnHotReload);
+		}
+#endif
+	}
+
+	void OnEndFrame()
+	{
+		// Typed array views are frame-scoped
+		TypedArrayViews->NeuterAll();
+
+		// Delegates in batched mode deliver once per frame
+		Delegates->FlushBatchedDelegates();
+
+		// Delegates of destroyed objects, a few per frame
+		Delegates->SweepDelegates(GetDefault<UJavascriptSettings>()->DelegateSweepBatchSize);
+
+		// Promise reactions queued outside of timers
+		{
+			Isolate::Scope isolate_scope(isolate_);
+			isolate_->RunMicrotasks();
+		}
+	}
+
+#if WITH_EDITOR
+	void OnHotReload(bool bWasTriggeredAutomatically)
+	{
+		InvalidateCallPlans();
+
+		// Hot reload may bring new classes
+		UnresolvedExports.Empty();
 	}
+#endif
 
 	void InitializeGlobalTemplate()
 	{
+		SCOPE_CYCLE_COUNTER(STAT_JavascriptInitializeGlobalTemplate);
+
+		const double StartTime = FPlatformTime::Seconds();
+
 		// Declares isolate/handle scope
 		Isolate::Scope isolate_scope(isolate_);
 		HandleScope handle_scope(isolate_);
@@ -207,6 +441,36 @@ public:
 		// Save it into the persistant handle
 		GlobalTemplate.Reset(isolate_, ObjectTemplate);
 
+		if (bLazyExport)
+		{
+			ExportOnDemand(ObjectTemplate);
+		}
+		else
+		{
+			ExportAll();
+		}
+
+		ExportConsole(ObjectTemplate);
+
+		ExportMemory(ObjectTemplate);
+
+		HeapStatistics Statistics;
+		isolate_->GetHeapStatistics(&Statistics);
+
+		// To compare startup cost between lazy and eager export
+		UE_LOG(Javascript, Log, TEXT("Global template initialized in %.2fms (%s export) : %d classes, %d structs, %d KB heap used"),
+			(FPlatformTime::Seconds() - StartTime) * 1000,
+			bLazyExport ? TEXT("lazy") : TEXT("eager"),
+			ClassToFunctionTemplateMap.Num(),
+			ScriptStructToFunctionTemplateMap.Num(),
+			(int32)(Statistics.used_heap_size() / 1024));
+	}		
+
+	virtual void ExportAll() override
+	{
+		Isolate::Scope isolate_scope(isolate_);
+		HandleScope handle_scope(isolate_);
+
 		// Export all structs
 		for (TObjectIterator<UScriptStruct> It; It; ++It)
 		{
@@ -218,24 +482,142 @@ public:
 		{
 			ExportClass(*It);
 		}
+	}
 
-		ExportConsole(ObjectTemplate);
+	// Resolves an exported name(eg. 'Actor', 'Vector') into its function template, exporting it if needed.
+	Local<FunctionTemplate> ExportByName(const FString& Name)
+	{
+		if (UnresolvedExports.Contains(Name))
+		{
+			return Local<FunctionTemplate>();
+		}
 
-		ExportMemory(ObjectTemplate);
-	}		
+		SCOPE_CYCLE_COUNTER(STAT_JavascriptExportOnDemand);
+
+		auto ObjectName = FV8Config::Unsafeify(Name);
+		if (ObjectName.Len() > 0 && FChar::IsAlpha(ObjectName[0]))
+		{
+			if (auto Class = FindObject<UClass>(ANY_PACKAGE, *ObjectName))
+			{
+				return ExportClass(Class);
+			}
+			else if (auto ScriptStruct = FindObject<UScriptStruct>(ANY_PACKAGE, *ObjectName))
+			{
+				return ExportStruct(ScriptStruct);
+			}
+		}
+
+		UnresolvedExports.Add(Name);
+		return Local<FunctionTemplate>();
+	}
+
+	void ExportOnDemand(Local<ObjectTemplate> global_templ)
+	{
+		// Called only for names which are not found on the global object(non-masking)
+		auto Getter = [](Local<Name> property, const PropertyCallbackInfo<Value>& info) {
+			auto isolate = info.GetIsolate();
+
+			if (!property->IsString()) return;
+
+			auto Template = GetSelf(isolate)->ExportByName(StringFromV8(property));
+			if (!Template.IsEmpty())
+			{
+				auto func = Template->GetFunction();
+
+				// Define it on this global as well, only the context which exported it first has it otherwise
+				info.Holder()->CreateDataProperty(isolate->GetCurrentContext(), property, func);
+
+				info.GetReturnValue().Set(func);
+			}
+		};
+
+		// Lists every exportable name so that enumeration(eg. auto-completion) still sees them
+		auto Enumerator = [](const PropertyCallbackInfo<Array>& info) {
+			auto isolate = info.GetIsolate();
+
+			TArray<FString> Names;
+
+			for (TObjectIterator<UScriptStruct> It; It; ++It)
+			{
+				Names.Add(FV8Config::Safeify(It->GetName()));
+			}
+
+			for (TObjectIterator<UClass> It; It; ++It)
+			{
+				Names.Add(FV8Config::Safeify(It->GetName()));
+			}
+
+			auto arr = Array::New(isolate, Names.Num());
+			for (int32 Index = 0; Index < Names.Num(); ++Index)
+			{
+				arr->Set(Index, V8_KeywordString(isolate, Names[Index]));
+			}
+
+			info.GetReturnValue().Set(arr);
+		};
+
+		global_templ->SetHandler(NamedPropertyHandlerConfiguration(
+			Getter, 
+			nullptr, 
+			nullptr, 
+			nullptr, 
+			Enumerator, 
+			Local<Value>(), 
+			(PropertyHandlerFlags)((int)PropertyHandlerFlags::kNonMasking | (int)PropertyHandlerFlags::kOnlyInterceptStrings)
+			));
+	}
 
 	~FJavascriptIsolateImplementation()
 	{
+#if WITH_EDITOR
+		if (auto HotReload = FModuleManager::GetModulePtr<IHotReloadInterface>("HotReload"))
+		{
+			HotReload->OnHotReload().Remove(OnHotReloadHandle);
+		}
+#endif
+
+		FCoreDelegates::OnEndFrame.Remove(OnEndFrameHandle);
+
 		ReleaseAllPersistentHandles();		
 
+		delete TypedArrayViews;
+		TypedArrayViews = nullptr;
+
+		delete GCScheduler;
+		GCScheduler = nullptr;
+
 		Delegates->Destroy();
 		Delegates = nullptr;
 
+		UE_LOG(Javascript, Log, TEXT("Keyword cache : %d hits, %d misses"), StringCache->NumHits, StringCache->NumMisses);
+
+		delete StringCache;
+		StringCache = nullptr;
+
 		isolate_->Dispose();
 	}	
 
 	void ReleaseAllPersistentHandles()
 	{
+		// Release all call plans (they hold interned parameter names)
+		CallPlans.Empty();
+
+		BoundBuffer.Reset();
+
+		// Release all interned keys
+		StringCache->Empty();
+
+		// Release all typed array views
+		TypedArrayViews->NeuterAll();
+
+		// Release all lazy arrays
+		for (auto Lazy : LazyArrays)
+		{
+			delete Lazy;
+		}
+		LazyArrays.Empty();
+		LazyArrayTemplate.Reset();
+
 		// Release all exported classes
 		ClassToFunctionTemplateMap.Empty();
 
@@ -283,21 +665,209 @@ public:
 		}
 	}
 
+	virtual void ForceGC() override
+	{
+		GCScheduler->CollectAll();
+	}
+
+	virtual void SetArrayBufferPoolSize(int32 SizeKB) override
+	{
+		AllocatorInstance.SetMaxBytesHeld(SizeKB * 1024);
+	}
+
+	virtual void GetStats(FJavascriptIsolateStats& OutStats) override
+	{
+		OutStats.NumArrayBuffers = AllocatorInstance.NumAllocations;
+		OutStats.ArrayBufferBytes = (int32)AllocatorInstance.AllocatedBytes;
+		OutStats.ArrayBufferPoolBytes = AllocatorInstance.GetBytesHeld();
+		for (int32 ClassIndex = 0; ClassIndex < FPooledArrayBufferAllocator::NumClasses; ++ClassIndex)
+		{
+			const auto& Class = AllocatorInstance.GetClass(ClassIndex);
+			OutStats.ArrayBufferPoolHits += Class.NumHits;
+			OutStats.ArrayBufferPoolMisses += Class.NumAllocs - Class.NumHits;
+			OutStats.ArrayBufferPoolAllocs.Add(Class.NumAllocs);
+			OutStats.ArrayBufferPoolFrees.Add(Class.NumFrees);
+		}
+		OutStats.NumClassTemplates = ClassToFunctionTemplateMap.Num();
+		OutStats.NumStructTemplates = ScriptStructToFunctionTemplateMap.Num();
+
+		HeapStatistics HeapStats;
+		isolate_->GetHeapStatistics(&HeapStats);
+		OutStats.UsedHeapSizeKB = (int32)(HeapStats.used_heap_size() / 1024);
+		OutStats.TotalHeapSizeKB = (int32)(HeapStats.total_heap_size() / 1024);
+	}
+
 	// To tell Unreal engine's GC not to destroy these objects!
 	virtual void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector) override
 	{
+		GCScheduler->OnEngineGarbageCollection();
+
 		// All classes
 		for (auto It = ClassToFunctionTemplateMap.CreateIterator(); It; ++It)
 		{
 			Collector.AddReferencedObject(It.Key(), InThis);
 		}
 
-		// All structs
-		for (auto It = ScriptStructToFunctionTemplateMap.CreateIterator(); It; ++It)
-		{
-			Collector.AddReferencedObject(It.Key(), InThis);
-		}
-	}	
+		// All structs
+		for (auto It = ScriptStructToFunctionTemplateMap.CreateIterator(); It; ++It)
+		{
+			Collector.AddReferencedObject(It.Key(), InThis);
+		}
+
+		// Objects within lazy arrays
+		for (auto Lazy : LazyArrays)
+		{
+			Lazy->AddReferencedObjects(InThis, Collector);
+		}
+
+		// Delegate dispatchers
+		Delegates->AddReferencedObjects(InThis, Collector);
+	}	
+
+	Local<FunctionTemplate> GetLazyArrayTemplate()
+	{
+		if (!LazyArrayTemplate.IsEmpty())
+		{
+			return Local<FunctionTemplate>::New(isolate_, LazyArrayTemplate);
+		}
+
+		FIsolateHelper I(isolate_);
+
+		auto Getter = [](uint32_t Index, const PropertyCallbackInfo<Value>& info) {
+			auto isolate = info.GetIsolate();
+			auto self = info.Holder();
+			auto Lazy = FLazyArray::FromV8(self);
+
+			if (Index >= (uint32_t)Lazy->Num()) return;
+
+			auto cache = self->GetInternalField(2).As<Array>();
+			auto cached = cache->Get(Index);
+			if (cached.IsEmpty() || cached->IsUndefined())
+			{
+				cached = ReadProperty(isolate, Lazy->Property->Inner, Lazy->GetRawPtr(Index), FNoPropertyOwner());
+				cache->Set(Index, cached);
+			}
+
+			info.GetReturnValue().Set(cached);
+		};
+
+		auto Setter = [](uint32_t Index, Local<Value> value, const PropertyCallbackInfo<Value>& info) {
+			auto isolate = info.GetIsolate();
+			auto self = info.Holder();
+			auto Lazy = FLazyArray::FromV8(self);
+
+			if (Index >= (uint32_t)Lazy->Num())
+			{
+				FIsolateHelper(isolate).Throw(TEXT("Lazy arrays cannot grow"));
+				return;
+			}
+
+			// Native copy stays authoritative, element is wrapped again on next access
+			WriteProperty(isolate, Lazy->Property->Inner, Lazy->GetRawPtr(Index), value);
+			self->GetInternalField(2).As<Array>()->Set(Index, Undefined(isolate));
+
+			info.GetReturnValue().Set(value);
+		};
+
+		auto Query = [](uint32_t Index, const PropertyCallbackInfo<Integer>& info) {
+			auto Lazy = FLazyArray::FromV8(info.Holder());
+
+			if (Index < (uint32_t)Lazy->Num())
+			{
+				info.GetReturnValue().Set(Integer::New(info.GetIsolate(), DontDelete));
+			}
+		};
+
+		auto Enumerator = [](const PropertyCallbackInfo<Array>& info) {
+			auto isolate = info.GetIsolate();
+			auto Lazy = FLazyArray::FromV8(info.Holder());
+			auto Num = Lazy->Num();
+
+			auto out = Array::New(isolate, Num);
+			for (int32 Index = 0; Index < Num; ++Index)
+			{
+				out->Set(Index, Integer::New(isolate, Index));
+			}
+
+			info.GetReturnValue().Set(out);
+		};
+
+		auto LengthGetter = [](Local<String> property, const PropertyCallbackInfo<Value>& info) {
+			info.GetReturnValue().Set(FLazyArray::FromV8(info.Holder())->Num());
+		};
+
+		// Materializes all elements
+		auto toJSON = [](const FunctionCallbackInfo<Value>& info) {
+			auto isolate = info.GetIsolate();
+			auto self = info.This();
+
+			if (!self->IsObject() || !GetSelf(isolate)->GetLazyArrayTemplate()->HasInstance(self))
+			{
+				return;
+			}
+
+			auto Num = FLazyArray::FromV8(self)->Num();
+			auto out = Array::New(isolate, Num);
+			for (int32 Index = 0; Index < Num; ++Index)
+			{
+				out->Set(Index, self->Get(Index));
+			}
+
+			info.GetReturnValue().Set(out);
+		};
+
+		auto Template = I.FunctionTemplate();
+		Template->SetClassName(I.Keyword("LazyArray"));
+
+		auto Instance = Template->InstanceTemplate();
+		Instance->SetInternalFieldCount(FLazyArray::NumInternalFields);
+		Instance->SetHandler(IndexedPropertyHandlerConfiguration(Getter, Setter, Query, nullptr, Enumerator));
+		Instance->SetAccessor(I.Keyword("length"), LengthGetter, 0, Local<Value>(), DEFAULT, (PropertyAttribute)(ReadOnly | DontEnum | DontDelete));
+
+		Template->PrototypeTemplate()->Set(I.Keyword("toJSON"), I.FunctionTemplate(toJSON));
+
+		LazyArrayTemplate.Reset(isolate_, Template);
+
+		return Template;
+	}
+
+	Local<Value> CreateLazyArray(UArrayProperty* Property, uint8* Buffer)
+	{
+		auto Template = GetLazyArrayTemplate();
+		auto Constructor = Template->GetFunction();
+
+		// Array.prototype behind our prototype gives forEach/map/for-of and the like
+		auto Prototype = Constructor->Get(V8_KeywordString(isolate_, "prototype"))->ToObject();
+		auto ArrayPrototype = Array::New(isolate_)->GetPrototype();
+		if (!Prototype->GetPrototype()->StrictEquals(ArrayPrototype))
+		{
+			Prototype->SetPrototype(ArrayPrototype);
+		}
+
+		auto Lazy = new FLazyArray(Property, Property->ContainerPtrToValuePtr<void>(Buffer));
+		LazyArrays.Add(Lazy);
+
+		auto Object = Constructor->NewInstance();
+		Object->SetAlignedPointerInInternalField(0, nullptr);
+		Object->SetAlignedPointerInInternalField(1, Lazy);
+		Object->SetInternalField(2, Array::New(isolate_, Lazy->Num()));
+
+		Lazy->Handle.Reset(isolate_, Object);
+		Lazy->Handle.SetWeak<FLazyArray>(Lazy, [](const WeakCallbackData<v8::Object, FLazyArray>& data) {
+			auto Lazy = data.GetParameter();
+
+			GetSelf(data.GetIsolate())->LazyArrays.Remove(Lazy);
+
+			delete Lazy;
+		});
+
+		return Object;
+	}
+
+	bool IsLazyArray(Local<Value> Value)
+	{
+		return Value->IsObject() && !LazyArrayTemplate.IsEmpty() && GetLazyArrayTemplate()->HasInstance(Value);
+	}
 
 	Local<Value> InternalReadProperty(UProperty* Property, uint8* Buffer, const IPropertyOwner& Owner)
 	{
@@ -324,7 +894,7 @@ public:
 		else if (auto p = Cast<UNameProperty>(Property))
 		{
 			auto name = p->GetPropertyValue_InContainer(Buffer);
-			return I.Keyword(name.ToString());
+			return I.Keyword(name);
 		}
 		else if (auto p = Cast<UStrProperty>(Property))
 		{
@@ -356,7 +926,16 @@ public:
 		}
 		else if (auto p = Cast<UStructProperty>(Property))
 		{
-			if (auto ScriptStruct = Cast<UScriptStruct>(p->Struct))
+			if (p->Struct == FJavascriptBuffer::StaticStruct())
+			{
+				auto JavascriptBuffer = p->ContainerPtrToValuePtr<FJavascriptBuffer>(Buffer);
+				if (!JavascriptBuffer->Data) return Undefined(isolate_);
+
+				auto Result = ArrayBuffer::New(isolate_, JavascriptBuffer->Size);
+				FMemory::Memcpy(Result->GetContents().Data(), JavascriptBuffer->Data, JavascriptBuffer->Size);
+				return Result;
+			}
+			else if (auto ScriptStruct = Cast<UScriptStruct>(p->Struct))
 			{	
 				return ExportStructInstance(ScriptStruct, p->ContainerPtrToValuePtr<uint8>(Buffer), Owner);
 			}			
@@ -369,7 +948,28 @@ public:
 		}		
 		else if (auto p = Cast<UArrayProperty>(Property))
 		{
+			if (FTypedArrays::IsNumeric(p->Inner))
+			{
+				auto Mode = GetTypedArrayMode(p);
+				if (Mode == EJavascriptTypedArrayMode::View)
+				{
+					return TypedArrayViews->Get(p, Buffer, Owner);
+				}
+				else if (Mode == EJavascriptTypedArrayMode::Copy)
+				{
+					FScriptArrayHelper_InContainer helper(p, Buffer);
+					return FTypedArrays::Copy(isolate_, p, helper);
+				}
+			}
+
 			FScriptArrayHelper_InContainer helper(p, Buffer);
+
+			// Parameters/return values are copied and wrapped on access
+			if (Owner.Owner == EPropertyOwner::None && LazyArrayThreshold > 0 && helper.Num() >= LazyArrayThreshold && FLazyArray::CanBeLazy(p))
+			{
+				return CreateLazyArray(p, Buffer);
+			}
+
 			auto len = (uint32_t)(helper.Num());
 			auto arr = Array::New(isolate_, len);
 			auto context = isolate_->GetCurrentContext();
@@ -404,6 +1004,35 @@ public:
 		}
 	}
 
+	EJavascriptTypedArrayMode::Type GetTypedArrayMode(UArrayProperty* Property)
+	{
+		if (ForcedTypedArrayMode >= 0)
+		{
+			return (EJavascriptTypedArrayMode::Type)ForcedTypedArrayMode;
+		}
+
+		if (auto Mode = TypedArrayModes.Find(Property))
+		{
+			return *Mode;
+		}
+
+		auto Settings = GetDefault<UJavascriptSettings>();
+		auto Mode = Settings->TypedArrayMode.GetValue();
+
+		auto Owner = Property->GetOwnerStruct();
+		auto Name = FString::Printf(TEXT("%s.%s"), Owner ? *Owner->GetName() : TEXT(""), *Property->GetName());
+		for (const auto& Override : Settings->TypedArrayProperties)
+		{
+			if (Override.Property == Name)
+			{
+				Mode = Override.Mode.GetValue();
+				break;
+			}
+		}
+
+		return TypedArrayModes.Add(Property, Mode);
+	}
+
 	void ReadOffStruct(Local<Object> v8_obj, UStruct* Struct, uint8* struct_buffer)
 	{
 		FIsolateHelper I(isolate_);
@@ -413,7 +1042,7 @@ public:
 			auto Property = *PropertyIt;
 			auto PropertyName = Property->GetFName();
 
-			auto name = I.Keyword(PropertyName.ToString());
+			auto name = I.Keyword(PropertyName);
 			auto value = v8_obj->Get(name);
 
 			if (!value.IsEmpty() && !value->IsUndefined())
@@ -465,7 +1094,11 @@ public:
 		}
 		else if (auto p = Cast<UStructProperty>(Property))
 		{
-			if (auto ScriptStruct = Cast<UScriptStruct>(p->Struct))
+			if (p->Struct == FJavascriptBuffer::StaticStruct())
+			{
+				*p->ContainerPtrToValuePtr<FJavascriptBuffer>(Buffer) = BufferFromV8(Value);
+			}
+			else if (auto ScriptStruct = Cast<UScriptStruct>(p->Struct))
 			{
 				auto Instance = FStructMemoryInstance::FromV8(Value);
 
@@ -506,10 +1139,24 @@ public:
 		}		
 		else if (auto p = Cast<UArrayProperty>(Property))
 		{
-			if (Value->IsArray())
+			if (Value->IsTypedArray() && FTypedArrays::IsMatchingTypedArray(p->Inner, Value))
+			{
+				FScriptArrayHelper_InContainer helper(p, Buffer);
+				FTypedArrays::Write(p, helper, Value);
+
+				// Views over reallocated memory must go
+				TypedArrayViews->Validate();
+			}
+			else if (IsLazyArray(Value) && FLazyArray::FromV8(Value->ToObject())->Property->Inner->SameType(p->Inner))
+			{
+				p->CopyCompleteValue(p->ContainerPtrToValuePtr<void>(Buffer), &FLazyArray::FromV8(Value->ToObject())->Array);
+			}
+			else if (Value->IsArray() || Value->IsTypedArray() || IsLazyArray(Value))
 			{
-				auto arr = Handle<Array>::Cast(Value);
-				auto len = arr->Length();
+				auto arr = Handle<Object>::Cast(Value);
+				auto len = Value->IsArray() ? Handle<Array>::Cast(Value)->Length() : 
+					Value->IsTypedArray() ? (uint32_t)Handle<TypedArray>::Cast(Value)->Length() :
+					(uint32_t)FLazyArray::FromV8(arr)->Num();
 
 				FScriptArrayHelper_InContainer helper(p, Buffer);
 
@@ -528,6 +1175,8 @@ public:
 				{
 					WriteProperty(isolate_, p->Inner, helper.GetRawPtr(Index), arr->Get(Index));
 				}
+
+				TypedArrayViews->Validate();
 			}
 			else
 			{
@@ -560,6 +1209,11 @@ public:
 		}
 	};		
 	
+	virtual bool IsUsingSnapshot() const override
+	{
+		return bUsingSnapshot;
+	}
+
 	virtual Local<ObjectTemplate> GetGlobalTemplate() override
 	{
 		return Local<ObjectTemplate>::New(isolate_, GlobalTemplate);
@@ -636,6 +1290,31 @@ public:
 			ReadOnly);
 	}	
 
+	static void TypedArrayScope(const FunctionCallbackInfo<Value>& info, EJavascriptTypedArrayMode::Type Mode)
+	{
+		FIsolateHelper I(info.GetIsolate());
+
+		if (info.Length() != 1 || !info[0]->IsFunction())
+		{
+			I.Throw(TEXT("A function needed"));
+			return;
+		}
+
+		auto Self = GetSelf(info.GetIsolate());
+		auto Saved = Self->ForcedTypedArrayMode;
+		Self->ForcedTypedArrayMode = Mode;
+
+		auto fn = info[0].As<Function>();
+		auto result = fn->Call(info.This(), 0, nullptr);
+
+		Self->ForcedTypedArrayMode = Saved;
+
+		if (!result.IsEmpty())
+		{
+			info.GetReturnValue().Set(result);
+		}
+	}
+
 	void ExportMemory(Local<ObjectTemplate> global_templ)
 	{
 		FIsolateHelper I(isolate_);
@@ -649,20 +1328,19 @@ public:
 			Template->PrototypeTemplate()->Set(I.Keyword(name), I.FunctionTemplate(fn));
 		};		
 
-		// memory.bind
+		// memory.bind : buffer for *FromMemory/*ToMemory functions (kept alive, not externalized, until unbound)
 		add_fn("bind", [](const FunctionCallbackInfo<Value>& info)
 		{
-			FIsolateHelper I(info.GetIsolate());
+			auto isolate = info.GetIsolate();
+			auto Self = GetSelf(isolate);
 
-			if (info.Length() == 1 && info[0]->IsArrayBuffer())
+			if (info.Length() == 1 && (info[0]->IsArrayBuffer() || info[0]->IsArrayBufferView()))
 			{
-				auto arr = info[0].As<ArrayBuffer>();
-
-				GCurrentContents = arr->Externalize();
+				Self->BoundBuffer.Reset(isolate, info[0]);
 			}
 			else
 			{
-				GCurrentContents = v8::ArrayBuffer::Contents();
+				Self->BoundBuffer.Reset();
 			}
 
 			info.GetReturnValue().Set(info.Holder());
@@ -671,13 +1349,22 @@ public:
 		// memory.unbind
 		add_fn("unbind", [](const FunctionCallbackInfo<Value>& info)
 		{
-			FIsolateHelper I(info.GetIsolate());
-
-			GCurrentContents = v8::ArrayBuffer::Contents();
+			GetSelf(info.GetIsolate())->BoundBuffer.Reset();
 			
 			info.GetReturnValue().Set(info.Holder());
 		});
 
+		// memory.view(fn), memory.copy(fn) : numeric TArrays read within fn are typed arrays
+		add_fn("view", [](const FunctionCallbackInfo<Value>& info)
+		{
+			TypedArrayScope(info, EJavascriptTypedArrayMode::View);
+		});
+
+		add_fn("copy", [](const FunctionCallbackInfo<Value>& info)
+		{
+			TypedArrayScope(info, EJavascriptTypedArrayMode::Copy);
+		});
+
 		// console.void
 		add_fn("write", [](const FunctionCallbackInfo<Value>& info)
 		{
@@ -691,12 +1378,10 @@ public:
 				FArchive* Ar = IFileManager::Get().CreateFileWriter(*StringFromV8(info[0]), 0);
 				if (Ar)
 				{
-					if (data->IsArrayBuffer())
+					auto Buffer = BufferFromV8(data);
+					if (Buffer.Data)
 					{
-						auto arr = data.As<ArrayBuffer>();
-						auto Contents = arr->Externalize();
-
-						Ar->Serialize(Contents.Data(), Contents.ByteLength());
+						Ar->Serialize(Buffer.Data, Buffer.Size);
 					}
 
 					delete Ar;
@@ -718,46 +1403,59 @@ public:
 			ReadOnly);
 	}
 	
+	/** Callers hold the returned plan for the whole call; a nested call may rebuild or invalidate the map entry */
+	TSharedPtr<FJavascriptCallPlan> GetCallPlan(UFunction* Function)
+	{
+		auto PlanPtr = CallPlans.Find(Function);
+		if (PlanPtr && (*PlanPtr)->IsValidFor(Function))
+		{
+			INC_DWORD_STAT(STAT_JavascriptCallPlanHits);
+			return *PlanPtr;
+		}
+
+		INC_DWORD_STAT(STAT_JavascriptCallPlanMisses);
+
+		TSharedPtr<FJavascriptCallPlan> Plan = MakeShareable(new FJavascriptCallPlan(isolate_, Function));
+		CallPlans.Add(Function, Plan);
+		return Plan;
+	}
+
+	void InvalidateCallPlans()
+	{
+		CallPlans.Empty();
+
+		// Keyed by property, which may be gone along with the class being reloaded
+		TypedArrayModes.Empty();
+	}
+
 	template <typename Fn>
 	static Local<Value> CallFunction(Isolate* isolate, Local<Value> self, UFunction* Function, UObject* Object, Fn&& GetArg) 
 	{
-		FIsolateHelper I(isolate);
-
 		EscapableHandleScope handle_scope(isolate);
 
+		// Keep a reference : ProcessEvent may re-enter and replace this plan
+		const auto PlanRef = GetSelf(isolate)->GetCallPlan(Function);
+		const auto& Plan = *PlanRef;
+
 		// Allocate buffer(param size) in stack
-		uint8* Buffer = (uint8*)FMemory_Alloca(Function->ParmsSize);
+		uint8* Buffer = (uint8*)FMemory_Alloca(Plan.ParmsSize);
 
 		// Arguments should construct and destruct along this scope
-		FScopedArguments scoped_arguments(Function, Buffer);		
-
-		// Does this function return some parameters by reference?
-		bool bHasAnyOutParams = false;
+		FScopedArguments scoped_arguments(Plan, Buffer);
 
 		// Argument index
 		int ArgIndex = 0;
 
-		// Intentionally declares iterator outside for-loop scope
-		TFieldIterator<UProperty> It(Function);
-
 		// Iterate over input parameters
-		for (; It && (It->PropertyFlags & (CPF_Parm | CPF_ReturnParm)) == CPF_Parm; ++It)
+		for (const auto& Param : Plan.InputParams)
 		{
-			auto Prop = *It;
-
 			// Get argument from caller
 			auto arg = GetArg(ArgIndex++);
 
 			// Do we have valid argument?
 			if (!arg.IsEmpty() && !arg->IsUndefined())
 			{				
-				WriteProperty(isolate, Prop, Buffer, arg);
-			}							
-
-			// This is 'out ref'!
-			if ((It->PropertyFlags & (CPF_ConstParm | CPF_OutParm)) == CPF_OutParm)
-			{
-				bHasAnyOutParams = true;
+				Param.Write(isolate, Param.Property, Buffer, Param.Offset, arg);
 			}
 		}
 
@@ -779,66 +1477,34 @@ public:
 			Object->ProcessEvent(Function, Buffer);
 		}
 
+		// Native code may have reallocated arrays which are viewed
+		GetSelf(isolate)->TypedArrayViews->Validate();
+
 		// In case of 'out ref'
-		if (bHasAnyOutParams)
+		if (Plan.bHasAnyOutParams)
 		{
 			// Allocate an object to pass return values within
 			auto OutParameters = Object::New(isolate);
 
-			// Iterate over parameters again
-			for (TFieldIterator<UProperty> It(Function); It; ++It)
+			// Return value as '$', 'T&' as its name
+			for (const auto& Param : Plan.OutParams)
 			{
-				UProperty* Param = *It;
-				
-				auto PropertyFlags = Param->GetPropertyFlags();
-
-				// pass return parameter as '$'
-				if (PropertyFlags & CPF_ReturnParm)
-				{
-					// value can be null if isolate is in trouble
-					auto value = ReadProperty(isolate, Param, Buffer, FNoPropertyOwner());
-					if (!value.IsEmpty())
-					{
-						OutParameters->Set(
-							// "$"
-							I.Keyword("$"),
-							// property value
-							value
-							);
-					}
-				}
-				// rejects 'const T&' and pass 'T&' as its name
-				else if ((PropertyFlags & (CPF_ConstParm | CPF_OutParm)) == CPF_OutParm)
+				// value can be null if isolate is in trouble
+				auto value = Param.Read(isolate, Param.Property, Buffer, Param.Offset);
+				if (!value.IsEmpty())
 				{
-					// value can be null if isolate is in trouble
-					auto value = ReadProperty(isolate, Param, Buffer, FNoPropertyOwner());
-					if (!value.IsEmpty())
-					{
-						OutParameters->Set(
-							// parameter name
-							I.Keyword(Param->GetName()),
-							// property value
-							value
-							);
-					}
+					OutParameters->Set(Local<String>::New(isolate, Param.Name), value);
 				}
 			}
 
 			// We're done
 			return handle_scope.Escape(OutParameters);
 		}
-		else
+		else if (Plan.ReturnParamIndex >= 0)
 		{
-			// Iterate to fill out return parameter (if we have one)
-			for (; It; ++It)
-			{
-				UProperty* Param = *It;
-				if (Param->GetPropertyFlags() & CPF_ReturnParm)
-				{
-					return handle_scope.Escape(ReadProperty(isolate, Param, Buffer, FNoPropertyOwner()));
-				}
-			}
-		}		
+			const auto& Param = Plan.OutParams[Plan.ReturnParamIndex];
+			return handle_scope.Escape(Param.Read(isolate, Param.Property, Buffer, Param.Offset));
+		}
 
 		// No return value available
 		return handle_scope.Escape(Undefined(isolate));
@@ -945,13 +1611,45 @@ public:
 		Template->PrototypeTemplate()->Set(function_name, function);		
 	}	
 	
+	template <typename PropertyAccessors>
+	bool GetTypedPropertyAccessors(UProperty* Property, AccessorGetterCallback& Getter, AccessorSetterCallback& Setter)
+	{
+		// Static arrays are read by their first element only, which the generic path takes care of
+		if (Property->ArrayDim != 1)
+		{
+			return false;
+		}
+
+		if (Property->IsA<UIntProperty>())
+		{
+			Getter = &TTypedPropertyAccessors<PropertyAccessors, FIntPropertyThunk>::Getter;
+			Setter = &TTypedPropertyAccessors<PropertyAccessors, FIntPropertyThunk>::Setter;
+		}
+		else if (Property->IsA<UFloatProperty>())
+		{
+			Getter = &TTypedPropertyAccessors<PropertyAccessors, FFloatPropertyThunk>::Getter;
+			Setter = &TTypedPropertyAccessors<PropertyAccessors, FFloatPropertyThunk>::Setter;
+		}
+		else if (Property->IsA<UBoolProperty>())
+		{
+			Getter = &TTypedPropertyAccessors<PropertyAccessors, FBoolPropertyThunk>::Getter;
+			Setter = &TTypedPropertyAccessors<PropertyAccessors, FBoolPropertyThunk>::Setter;
+		}
+		else
+		{
+			return false;
+		}
+
+		return true;
+	}
+
 	template <typename PropertyAccessors>
 	void ExportProperty(Handle<FunctionTemplate> Template, UProperty* PropertyToExport, int32 PropertyIndex) 
 	{
 		FIsolateHelper I(isolate_);
 
 		// Property getter
-		auto Getter = [](Local<String> property, const PropertyCallbackInfo<Value>& info) {
+		AccessorGetterCallback Getter = [](Local<String> property, const PropertyCallbackInfo<Value>& info) {
 			auto isolate = info.GetIsolate();
 
 			auto data = info.Data();
@@ -962,7 +1660,7 @@ public:
 		};
 
 		// Property setter
-		auto Setter = [](Local<String> property, Local<Value> value, const PropertyCallbackInfo<void>& info) {
+		AccessorSetterCallback Setter = [](Local<String> property, Local<Value> value, const PropertyCallbackInfo<void>& info) {
 			auto isolate = info.GetIsolate();
 
 			auto data = info.Data();
@@ -972,16 +1670,90 @@ public:
 			PropertyAccessors::Set(isolate, info.This(), Property, value);			
 		};
 
+		void* Data = PropertyToExport;
+
+		// int32/float/bool are accessed directly at the offset without going through ReadProperty/WriteProperty
+		if (GetTypedPropertyAccessors<PropertyAccessors>(PropertyToExport, Getter, Setter))
+		{
+			auto AccessorData = new FPropertyAccessorData;
+			AccessorData->Property = PropertyToExport;
+			AccessorData->Offset = PropertyToExport->GetOffset_ForInternal();
+			PropertyAccessorData.Add(AccessorData);
+
+			Data = AccessorData;
+		}
+
 		Template->PrototypeTemplate()->SetAccessor(
 			I.Keyword(FV8Config::Safeify(PropertyToExport->GetName())),
 			Getter, 
 			Setter, 
-			I.External(PropertyToExport),
+			I.External(Data),
 			DEFAULT,
 			(PropertyAttribute)(DontDelete | (FV8Config::IsWriteDisabledProperty(PropertyToExport) ? ReadOnly : 0))
 			);
 	}
 
+	template <typename Thunk>
+	void BenchmarkPropertyAccess(UProperty* Property, uint8* Buffer, int32 Iterations)
+	{
+		FPropertyAccessorData Data;
+		Data.Property = Property;
+		Data.Offset = Property->GetOffset_ForInternal();
+
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < Iterations; ++Index)
+		{
+			HandleScope handle_scope(isolate_);
+			InternalWriteProperty(Property, Buffer, InternalReadProperty(Property, Buffer, FNoPropertyOwner()));
+		}
+		double GenericTime = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < Iterations; ++Index)
+		{
+			HandleScope handle_scope(isolate_);
+			Thunk::Write(Data, Buffer, Thunk::Box(isolate_, Thunk::Read(Data, Buffer)));
+		}
+		double ThunkTime = FPlatformTime::Seconds() - StartTime;
+
+		UE_LOG(Javascript, Log, TEXT("%s.%s : generic %.1fns, typed %.1fns per read+write"),
+			*Property->GetOwnerStruct()->GetName(),
+			*Property->GetName(),
+			GenericTime * 1e9 / Iterations,
+			ThunkTime * 1e9 / Iterations);
+	}
+
+	// Compares property access through InternalRead/WriteProperty with typed thunks on AActor's CDO
+	void BenchmarkPropertyAccess(int32 Iterations)
+	{
+		Isolate::Scope isolate_scope(isolate_);
+		HandleScope handle_scope(isolate_);
+
+		auto context = Context::New(isolate_);
+		Context::Scope context_scope(context);
+
+		auto Object = GetMutableDefault<AActor>();
+
+		for (TFieldIterator<UProperty> It(Object->GetClass()); It; ++It)
+		{
+			auto Property = *It;
+			if (Property->ArrayDim != 1) continue;
+
+			if (Property->IsA<UIntProperty>())
+			{
+				BenchmarkPropertyAccess<FIntPropertyThunk>(Property, (uint8*)Object, Iterations);
+			}
+			else if (Property->IsA<UFloatProperty>())
+			{
+				BenchmarkPropertyAccess<FFloatPropertyThunk>(Property, (uint8*)Object, Iterations);
+			}
+			else if (Property->IsA<UBoolProperty>())
+			{
+				BenchmarkPropertyAccess<FBoolPropertyThunk>(Property, (uint8*)Object, Iterations);
+			}
+		}
+	}
+
 	void ExportHelperFunctions(UClass* ClassToExport, Local<FunctionTemplate> Template)
 	{
 		// Bind blue print library!
@@ -1114,6 +1886,42 @@ public:
 		Template->Set(I.Keyword("Load"), I.FunctionTemplate(fn, ClassToExport));
 	}
 
+	static void Object_proxy_Getter(Local<String> property, const PropertyCallbackInfo<Value>& info)
+	{
+		auto value = info.This()->GetHiddenValue(property);
+		if (!value.IsEmpty())
+		{
+			info.GetReturnValue().Set(value);
+		}
+	}
+
+	static void Object_proxy_Setter(Local<String> property, Local<Value> value, const PropertyCallbackInfo<void>& info)
+	{
+		auto self = info.This();
+
+		// First assignment : the object gets its own (enumerable) proxy property, as it had with a plain assignment
+		if (self->GetHiddenValue(property).IsEmpty())
+		{
+			self->SetAccessor(property, &Object_proxy_Getter, &Object_proxy_Setter);
+		}
+
+		self->SetHiddenValue(property, value);
+
+		if (auto Context = FJavascriptContext::FromV8(info.GetIsolate()->GetCurrentContext()))
+		{
+			Context->InvalidateProxyFunctions(UObjectFromV8(self));
+		}
+	}
+
+	// proxy is kept in a hidden value, so that reassigning it invalidates proxy functions resolved for the object.
+	// Members added to or replaced in a proxy later on are not seen until then; 'obj.proxy = obj.proxy' re-resolves.
+	void AddProperty_Object_proxy(Local<FunctionTemplate> Template)
+	{
+		FIsolateHelper I(isolate_);
+
+		Template->PrototypeTemplate()->SetAccessor(I.Keyword("proxy"), &Object_proxy_Getter, &Object_proxy_Setter);
+	}
+
 	void AddMemberFunction_Struct_C(Local<FunctionTemplate> Template, UStruct* StructToExport)
 	{
 		FIsolateHelper I(isolate_);
@@ -1192,7 +2000,7 @@ public:
 				{
 					auto PropertyName = Property->GetFName();
 
-					auto name = I.Keyword(PropertyName.ToString());
+					auto name = I.Keyword(PropertyName);
 					auto value = PropertyAccessor::Get(isolate, self, Property);
 					if (auto p = Cast<UObjectPropertyBase>(Property))
 					{
@@ -1200,7 +2008,21 @@ public:
 					}
 					else if (auto p = Cast<UArrayProperty>(Property))
 					{
-						if (auto q = Cast<UObjectPropertyBase>(p->Inner))
+						// Typed arrays are serialized as plain arrays
+						if (value->IsTypedArray())
+						{
+							auto arr = value->ToObject();
+							auto len = Handle<TypedArray>::Cast(value)->Length();
+
+							auto out_arr = Array::New(isolate, len);
+							out->Set(name, out_arr);
+
+							for (decltype(len) Index = 0; Index < len; ++Index)
+							{
+								out_arr->Set(Index, arr->Get(Index));
+							}
+						}
+						else if (auto q = Cast<UObjectPropertyBase>(p->Inner))
 						{
 							auto arr = Handle<Array>::Cast(value);
 							auto len = arr->Length();
@@ -1367,6 +2189,12 @@ public:
 		
 		AddMemberFunction_Struct_toJSON<FObjectPropertyAccessors>(Template, ClassToExport);
 
+		// Inherited by all classes
+		if (ClassToExport == UObject::StaticClass())
+		{
+			AddProperty_Object_proxy(Template);
+		}
+
 		Template->SetClassName(I.Keyword(ClassToExport->GetName()));
 
 		auto static_class = I.Keyword("StaticClass");
@@ -1510,7 +2338,7 @@ public:
 		}
 	}
 
-	Local<Value> ExportStructInstance(UScriptStruct* Struct, uint8* Buffer, const IPropertyOwner& Owner)
+	virtual Local<Value> ExportStructInstance(UScriptStruct* Struct, uint8* Buffer, const IPropertyOwner& Owner) override
 	{
 		FIsolateHelper I(isolate_);
 		if (!Struct || !Buffer)
@@ -1610,16 +2438,21 @@ public:
 	}
 
 	// For tracking exported entities
+	// Contexts may share this isolate, so the owning context is remembered rather than taken from the current one.
 	template <typename U, typename T>
-	void SetWeak(UniquePersistent<U>& Handle, T* GarbageCollectedObject)
+	void SetWeak(UniquePersistent<U>& Handle, T* GarbageCollectedObject, FJavascriptContext* OwnerContext = nullptr)
 	{		
-		typedef TPair<FJavascriptIsolateImplementation*, T*> WeakData;
-		typedef TPairInitializer<WeakData::KeyInitType, WeakData::ValueInitType> InitializerType;
+		struct WeakData
+		{
+			FJavascriptIsolateImplementation* Isolate;
+			FJavascriptContext* Context;
+			T* Object;
+		};
 
-		Handle.SetWeak<WeakData>(new WeakData(InitializerType(this, GarbageCollectedObject)), [](const WeakCallbackData<U, WeakData>& data) {
+		Handle.SetWeak<WeakData>(new WeakData{ this, OwnerContext, GarbageCollectedObject }, [](const WeakCallbackData<U, WeakData>& data) {
 			auto Parameter = data.GetParameter();
 
-			Parameter->Key->OnGarbageCollectedByV8(Parameter->Value);
+			Parameter->Isolate->OnGarbageCollectedByV8(Parameter->Context, Parameter->Object);
 
 			delete Parameter;
 		});
@@ -1660,30 +2493,41 @@ public:
 
 	void RegisterObject(UObject* UnrealObject, Local<Value> value)
 	{		
-		auto& result = GetContext()->ObjectToObjectMap.Add(UnrealObject, UniquePersistent<Value>(isolate_, value));
-		SetWeak(result, UnrealObject);		
+		auto Context = GetContext();
+		auto& result = Context->ObjectToObjectMap.Add(UnrealObject, UniquePersistent<Value>(isolate_, value));
+		SetWeak(result, UnrealObject, Context);		
 	}				
 
 	void RegisterScriptStructInstance(TSharedPtr<FStructMemoryInstance> MemoryObject, Local<Value> value)
 	{
-		auto& result = GetContext()->MemoryToObjectMap.Add(MemoryObject, UniquePersistent<Value>(isolate_, value));
-		SetWeak(result, MemoryObject.Get());
+		auto Context = GetContext();
+		auto& result = Context->MemoryToObjectMap.Add(MemoryObject, UniquePersistent<Value>(isolate_, value));
+		SetWeak(result, MemoryObject.Get(), Context);
+
+		MemoryObject->ReportExternalMemory(isolate_);
 	}
 
-	void OnGarbageCollectedByV8(FStructMemoryInstance* Memory)
+	void OnGarbageCollectedByV8(FJavascriptContext* Context, FStructMemoryInstance* Memory)
 	{
 		// We should keep ourselves clean
-		GetContext()->MemoryToObjectMap.Remove(Memory->AsShared());
+		if (Context)
+		{
+			Context->MemoryToObjectMap.Remove(Memory->AsShared());
+		}
 	}
 
-	void OnGarbageCollectedByV8(UObject* Object)
+	void OnGarbageCollectedByV8(FJavascriptContext* Context, UObject* Object)
 	{
 		if (auto klass = Cast<UClass>(Object))
 		{
 			ClassToFunctionTemplateMap.Remove(klass);
 		}
 
-		GetContext()->ObjectToObjectMap.Remove(Object);		
+		if (Context)
+		{
+			Context->ObjectToObjectMap.Remove(Object);
+			Context->ForgetProxyFunctions(Object);
+		}
 	}	
 
 	static FJavascriptIsolateImplementation* GetSelf(Isolate* isolate)
@@ -1697,6 +2541,125 @@ FJavascriptIsolate* FJavascriptIsolate::Create()
 	return new FJavascriptIsolateImplementation();
 }
 
+FJavascriptBuffer FArrayBufferAccessor::GetBuffer()
+{
+	auto isolate = Isolate::GetCurrent();
+	if (!isolate) return FJavascriptBuffer();
+
+	auto Self = FJavascriptIsolateImplementation::GetSelf(isolate);
+	if (Self->BoundBuffer.IsEmpty()) return FJavascriptBuffer();
+
+	HandleScope handle_scope(isolate);
+	return BufferFromV8(Local<Value>::New(isolate, Self->BoundBuffer));
+}
+
+int32 FArrayBufferAccessor::GetSize()
+{
+	return GetBuffer().Size;
+}
+
+void* FArrayBufferAccessor::GetData()
+{
+	return GetBuffer().Data;
+}
+
+void FArrayBufferAccessor::Discard()
+{
+	if (auto isolate = Isolate::GetCurrent())
+	{
+		FJavascriptIsolateImplementation::GetSelf(isolate)->BoundBuffer.Reset();
+	}
+}
+
+static void BenchmarkPropertyAccess(const TArray<FString>& Args)
+{
+	int32 Iterations = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 100000;
+
+	TSharedPtr<FJavascriptIsolateImplementation> Isolate(new FJavascriptIsolateImplementation());
+	Isolate->BenchmarkPropertyAccess(FMath::Max(Iterations, 1));
+}
+
+static FAutoConsoleCommand BenchmarkPropertyAccessCommand(
+	TEXT("Javascript.BenchmarkPropertyAccess"),
+	TEXT("Compares per-access cost of generic and typed property accessors. Usage: Javascript.BenchmarkPropertyAccess [Iterations]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkPropertyAccess)
+	);
+
+// Per frame : allocate a burst of scratch buffers (typed arrays, packets), then V8 frees them all
+static double BenchmarkArrayBufferAllocator(v8::ArrayBuffer::Allocator& Allocator, int32 Frames, int32 BuffersPerFrame)
+{
+	static const size_t Sizes[] = { 12, 16, 48, 64, 100, 256, 1024, 3000, 16384 };
+
+	TArray<void*> Buffers;
+	Buffers.SetNumUninitialized(BuffersPerFrame);
+
+	double StartTime = FPlatformTime::Seconds();
+	for (int32 Frame = 0; Frame < Frames; ++Frame)
+	{
+		for (int32 Index = 0; Index < BuffersPerFrame; ++Index)
+		{
+			Buffers[Index] = Allocator.Allocate(Sizes[Index % ARRAY_COUNT(Sizes)]);
+		}
+
+		for (int32 Index = 0; Index < BuffersPerFrame; ++Index)
+		{
+			Allocator.Free(Buffers[Index], Sizes[Index % ARRAY_COUNT(Sizes)]);
+		}
+	}
+	return (FPlatformTime::Seconds() - StartTime) * 1000 / Frames;
+}
+
+// Zeroed blocks beyond the pool, touching a single byte of each like a sparsely written buffer would
+static double BenchmarkLargeArrayBuffers(v8::ArrayBuffer::Allocator& Allocator, int32 Frames, int32 BuffersPerFrame, size_t Size)
+{
+	TArray<void*> Buffers;
+	Buffers.SetNumUninitialized(BuffersPerFrame);
+
+	double StartTime = FPlatformTime::Seconds();
+	for (int32 Frame = 0; Frame < Frames; ++Frame)
+	{
+		for (int32 Index = 0; Index < BuffersPerFrame; ++Index)
+		{
+			Buffers[Index] = Allocator.Allocate(Size);
+			((uint8*)Buffers[Index])[0] = 1;
+		}
+
+		for (int32 Index = 0; Index < BuffersPerFrame; ++Index)
+		{
+			Allocator.Free(Buffers[Index], Size);
+		}
+	}
+	return (FPlatformTime::Seconds() - StartTime) * 1000 / Frames;
+}
+
+static void BenchmarkArrayBufferAllocator(const TArray<FString>& Args)
+{
+	int32 Frames = FMath::Max(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1000, 1);
+	int32 BuffersPerFrame = FMath::Max(Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 1000, 1);
+
+	FMallocArrayBufferAllocator Malloc;
+	FPooledArrayBufferAllocator Pooled;
+	Pooled.SetMaxBytesHeld(GetDefault<UJavascriptSettings>()->ArrayBufferPoolSizeKB * 1024);
+
+	double MallocTime = BenchmarkArrayBufferAllocator(Malloc, Frames, BuffersPerFrame);
+	double PooledTime = BenchmarkArrayBufferAllocator(Pooled, Frames, BuffersPerFrame);
+
+	UE_LOG(Javascript, Log, TEXT("%d ArrayBuffers per frame : malloc %.3fms, pooled %.3fms per frame"), BuffersPerFrame, MallocTime, PooledTime);
+
+	const int32 LargeBuffersPerFrame = 16;
+	const size_t LargeSize = 1024 * 1024;
+	double LargeMallocTime = BenchmarkLargeArrayBuffers(Malloc, Frames, LargeBuffersPerFrame, LargeSize);
+	double LargePooledTime = BenchmarkLargeArrayBuffers(Pooled, Frames, LargeBuffersPerFrame, LargeSize);
+
+	UE_LOG(Javascript, Log, TEXT("%d zeroed %dKB ArrayBuffers per frame : malloc %.3fms, pooled %.3fms per frame"), LargeBuffersPerFrame, (int32)(LargeSize / 1024), LargeMallocTime, LargePooledTime);
+}
+
+static FAutoConsoleCommand BenchmarkArrayBufferAllocatorCommand(
+	TEXT("Javascript.BenchmarkArrayBufferAllocator"),
+	TEXT("Compares per-frame cost of malloc and pooled ArrayBuffer allocators. Usage: Javascript.BenchmarkArrayBufferAllocator [Frames] [BuffersPerFrame]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkArrayBufferAllocator)
+	);
+
 Local<Value> FJavascriptIsolate::ReadProperty(Isolate* isolate, UProperty* Property, uint8* Buffer, const IPropertyOwner& Owner)
 {
 	return FJavascriptIsolateImplementation::GetSelf(isolate)->InternalReadProperty(Property, Buffer, Owner);
@@ -2,6 +2,7 @@
 
 struct FStructMemoryInstance;
 class FJavascriptIsolate;
+struct FJavascriptIsolateStats;
 
 struct FPendingClassConstruction
 {
@@ -38,9 +39,15 @@ public:
 	static void WriteProperty(v8::Isolate* isolate, UProperty* Property, uint8* Buffer, v8::Handle<v8::Value> Value);
 
 	virtual v8::Local<v8::Value> ExportObject(UObject* Object, bool bForce = false) = 0;
+	virtual v8::Local<v8::Value> ExportStructInstance(UScriptStruct* Struct, uint8* Buffer, const IPropertyOwner& Owner) = 0;
 	virtual v8::Local<v8::FunctionTemplate> ExportClass(UClass* Class, bool bAutoRegister = true) = 0;
 	virtual void RegisterClass(UClass* Class, v8::Local<v8::FunctionTemplate> Template) = 0;
+	virtual void ExportAll() = 0;
+	virtual bool IsUsingSnapshot() const = 0;
 	virtual v8::Local<v8::ObjectTemplate> GetGlobalTemplate() = 0;
 	virtual void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector) = 0;
+	virtual void ForceGC() = 0;
+	virtual void GetStats(FJavascriptIsolateStats& OutStats) = 0;
+	virtual void SetArrayBufferPoolSize(int32 SizeKB) = 0;
 	virtual ~FJavascriptIsolate() {}	
 };
\ No newline at end of file
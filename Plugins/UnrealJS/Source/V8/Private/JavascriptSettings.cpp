@@ -0,0 +1,35 @@
+#include "V8PCH.h"
+#include "JavascriptSettings.h"
+
+UJavascriptSettings::UJavascriptSettings(const FObjectInitializer& ObjectInitializer)
+: Super(ObjectInitializer)
+{
+	bLazyExport = true;
+
+	ComponentIsolateSharing = EJavascriptIsolateSharing::PerComponent;
+	MaxIsolatesPerPool = 1;
+	bBatchComponentTicks = false;
+
+	GCPolicy = EJavascriptGCPolicy::Idle;
+	TargetFrameTimeMs = 16.6f;
+	MaxIdleTimeMs = 4.0f;
+	LowMemoryHeapSizeMB = 256;
+	DelegateSweepBatchSize = 64;
+
+	DelegateBatchWindowMs = 0.0f;
+	DelegateBatchMaxQueue = 256;
+
+	TypedArrayMode = EJavascriptTypedArrayMode::Disabled;
+	LazyArrayThreshold = 0;
+
+	ArrayBufferPoolSizeKB = 1024;
+
+	bCodeCache = true;
+
+	bUseScriptBundle = true;
+	ScriptBundleFile = TEXT("Scripts/Scripts.jsbundle");
+
+	bUseSnapshot = false;
+	SnapshotFile = TEXT("Scripts/Snapshot.bin");
+	SnapshotModules.Add(TEXT("lodash.js"));
+}
@@ -0,0 +1,131 @@
+#include "V8PCH.h"
+#include "JavascriptSnapshot.h"
+#include "JavascriptSettings.h"
+#include "AsyncScriptLoader.h"
+
+using namespace v8;
+
+static const uint32 SnapshotMagicNumber = 0x4a53534e;
+
+const char* FJavascriptSnapshot::GlobalName = "$snapshot";
+
+// Script/module names are pasted into string literals
+static FString EscapeName(const FString& Name)
+{
+	return Name.Replace(TEXT("\\"), TEXT("\\\\")).Replace(TEXT("'"), TEXT("\\'"));
+}
+
+FString FJavascriptSnapshot::GetSnapshotFilename()
+{
+	return FPaths::GameContentDir() / GetDefault<UJavascriptSettings>()->SnapshotFile;
+}
+
+bool FJavascriptSnapshot::Build(const TArray<FString>& Paths)
+{
+	auto Settings = GetDefault<UJavascriptSettings>();
+
+	auto FindScript = [&](const FString& Filename, FString& OutText) {
+		for (const auto& Path : Paths)
+		{
+			if (FFileHelper::LoadFileToString(OutText, *(Path / Filename)))
+			{
+				return true;
+			}
+		}
+		UE_LOG(Javascript, Error, TEXT("Snapshot : %s not found"), *Filename);
+		return false;
+	};
+
+	// Assigned rather than declared with var, so that it is configurable and can be deleted on import
+	FString Source = FString::Printf(TEXT("this.%s = { modules : {}, scripts : {} };\n"), ANSI_TO_TCHAR(GlobalName));
+
+	for (const auto& Filename : Settings->SnapshotScripts)
+	{
+		FString Text;
+		if (!FindScript(Filename, Text)) return false;
+
+		Source.Append(FString::Printf(TEXT("%s\n;%s.scripts['%s'] = true;\n"), *Text, ANSI_TO_TCHAR(GlobalName), *EscapeName(Filename)));
+	}
+
+	// Module functions, wrapped as require() does; each context runs them with its own (__dirname, __filename, require, module)
+	for (const auto& Filename : Settings->SnapshotModules)
+	{
+		FString Text;
+		if (!FindScript(Filename, Text)) return false;
+
+		Source.Append(FString::Printf(TEXT("%s.modules['%s'] = %s;\n"), ANSI_TO_TCHAR(GlobalName), *EscapeName(Filename), *WrapModuleSource(Text)));
+	}
+
+	auto Blob = V8::CreateSnapshotDataBlob(TCHAR_TO_UTF8(*Source));
+	if (Blob.data == nullptr || Blob.raw_size == 0)
+	{
+		UE_LOG(Javascript, Error, TEXT("Failed to create snapshot"));
+		return false;
+	}
+
+	TArray<uint8> Data;
+	Data.Append((const uint8*)Blob.data, Blob.raw_size);
+	delete[] Blob.data;
+
+	auto Filename = GetSnapshotFilename();
+	TScopedPointer<FArchive> Ar(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!Ar.IsValid())
+	{
+		UE_LOG(Javascript, Error, TEXT("Failed to write snapshot : %s"), *Filename);
+		return false;
+	}
+
+	uint32 Magic = SnapshotMagicNumber;
+	FString Version = ANSI_TO_TCHAR(V8::GetVersion());
+	*Ar << Magic;
+	*Ar << Version;
+	*Ar << Data;
+
+	UE_LOG(Javascript, Log, TEXT("Snapshot saved : %s (%d KB, %d scripts, %d modules)"), *Filename, Data.Num() / 1024, Settings->SnapshotScripts.Num(), Settings->SnapshotModules.Num());
+
+	return true;
+}
+
+StartupData* FJavascriptSnapshot::Get()
+{
+	// Blob should outlive every isolate which is created from it
+	static TArray<uint8> Data;
+	static StartupData Blob;
+	static bool bLoaded = false;
+
+	if (!GetDefault<UJavascriptSettings>()->bUseSnapshot)
+	{
+		return nullptr;
+	}
+
+	if (!bLoaded)
+	{
+		bLoaded = true;
+
+		auto Filename = GetSnapshotFilename();
+		TScopedPointer<FArchive> Ar(IFileManager::Get().CreateFileReader(*Filename));
+		if (!Ar.IsValid())
+		{
+			UE_LOG(Javascript, Warning, TEXT("Snapshot not found : %s"), *Filename);
+			return nullptr;
+		}
+
+		uint32 Magic = 0;
+		FString Version;
+		*Ar << Magic;
+		*Ar << Version;
+
+		if (Magic != SnapshotMagicNumber || Version != ANSI_TO_TCHAR(V8::GetVersion()))
+		{
+			UE_LOG(Javascript, Warning, TEXT("Snapshot is stale, rebuild it with JavascriptSnapshot commandlet : %s"), *Filename);
+			return nullptr;
+		}
+
+		*Ar << Data;
+
+		Blob.data = (const char*)Data.GetData();
+		Blob.raw_size = Data.Num();
+	}
+
+	return Data.Num() ? &Blob : nullptr;
+}
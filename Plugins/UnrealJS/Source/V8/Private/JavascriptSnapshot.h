@@ -0,0 +1,19 @@
+#pragma once
+
+/** 
+ * Startup snapshot : a serialized heap which already has evaluated pure-javascript scripts and modules.
+ * The snapshot cannot hold any UObject, so everything bound to UObject(Root, GWorld, Context, ...) is exposed after deserialization.
+ */
+struct FJavascriptSnapshot
+{
+	/** Global object which holds evaluated modules and scripts within the snapshot */
+	static const char* GlobalName;
+
+	/** Builds a snapshot out of UJavascriptSettings::SnapshotScripts/SnapshotModules and saves it into SnapshotFile */
+	static bool Build(const TArray<FString>& Paths);
+
+	/** Returns the snapshot blob to create an isolate with, or nullptr if not available */
+	static v8::StartupData* Get();
+
+	static FString GetSnapshotFilename();
+};
@@ -0,0 +1,18 @@
+#include "V8PCH.h"
+#include "JavascriptSnapshotCommandlet.h"
+#include "JavascriptSnapshot.h"
+#include "IV8.h"
+
+UJavascriptSnapshotCommandlet::UJavascriptSnapshotCommandlet(const FObjectInitializer& ObjectInitializer)
+: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UJavascriptSnapshotCommandlet::Main(const FString& Params)
+{
+	return FJavascriptSnapshot::Build(IV8::Get().GetGlobalScriptSearchPaths()) ? 0 : 1;
+}
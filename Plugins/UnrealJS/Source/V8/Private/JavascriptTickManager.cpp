@@ -0,0 +1,230 @@
+#include "V8PCH.h"
+#include "JavascriptTickManager.h"
+#include "JavascriptIsolate.h"
+#include "JavascriptContext.h"
+#include "JavascriptComponent.h"
+#include "Translator.h"
+
+#include "JavascriptIsolate_Private.h"
+#include "JavascriptContext_Private.h"
+
+using namespace v8;
+
+DECLARE_CYCLE_STAT(TEXT("Batched component tick"), STAT_JavascriptBatchedComponentTick, STATGROUP_Javascript);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Batched component ticks"), STAT_JavascriptBatchedComponentTicks, STATGROUP_Javascript);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Batched tick dispatches"), STAT_JavascriptBatchedTickDispatches, STATGROUP_Javascript);
+
+namespace
+{
+	struct FBatchedTickEntry
+	{
+		TWeakObjectPtr<UJavascriptComponent> Component;
+		float TimeSinceLastTick;
+	};
+
+	struct FDueTick
+	{
+		UJavascriptComponent* Component;
+		UJavascriptContext* Context;
+		float DeltaTime;
+	};
+
+	struct FJavascriptBatchedTickFunction : FTickFunction
+	{
+		TWeakObjectPtr<UWorld> World;
+		TArray<FBatchedTickEntry> Entries;
+		bool bTicking{ false };
+
+		bool IsEmpty() const
+		{
+			for (const auto& Entry : Entries)
+			{
+				if (Entry.Component.IsValid()) return false;
+			}
+			return true;
+		}
+
+		virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override
+		{
+			SCOPE_CYCLE_COUNTER(STAT_JavascriptBatchedComponentTick);
+
+			// Components unregistered since the last tick
+			Entries.RemoveAll([](const FBatchedTickEntry& Entry) { return !Entry.Component.IsValid(); });
+
+			const bool bPaused = World.IsValid() && World->IsPaused();
+
+			TArray<FDueTick> Due;
+			Due.Reserve(Entries.Num());
+
+			for (auto& Entry : Entries)
+			{
+				auto Component = Entry.Component.Get();
+				if (!Component->IsRegistered() || !Component->PrimaryComponentTick.IsTickFunctionEnabled()) continue;
+				if (bPaused && !Component->PrimaryComponentTick.bTickEvenWhenPaused) continue;
+				if (TickType == LEVELTICK_ViewportsOnly && !Component->bTickInEditor) continue;
+
+				Entry.TimeSinceLastTick += DeltaTime;
+				if (Entry.TimeSinceLastTick < Component->TickInterval) continue;
+
+				Due.Add({ Component, Component->JavascriptContext, Entry.TimeSinceLastTick });
+				Entry.TimeSinceLastTick = 0;
+			}
+
+			if (Due.Num() == 0) return;
+
+			INC_DWORD_STAT_BY(STAT_JavascriptBatchedComponentTicks, Due.Num());
+
+			bTicking = true;
+
+			// Native part of the tick, OnTick is left to DispatchTicks
+			for (const auto& Tick : Due)
+			{
+				Tick.Component->TickComponent(Tick.DeltaTime, TickType, &Tick.Component->PrimaryComponentTick);
+			}
+
+			// Components sharing an isolate/context are next to each other
+			Due.Sort([](const FDueTick& A, const FDueTick& B) {
+				auto IsolateA = A.Component->JavascriptIsolate, IsolateB = B.Component->JavascriptIsolate;
+				return IsolateA != IsolateB ? IsolateA < IsolateB : A.Context < B.Context;
+			});
+
+			TArray<UJavascriptComponent*> Components;
+			TArray<float> DeltaTimes;
+
+			int32 Index = 0;
+			while (Index < Due.Num())
+			{
+				auto Context = Due[Index].Context;
+				if (!Context || !Context->JavascriptContext.IsValid())
+				{
+					++Index;
+					continue;
+				}
+
+				auto JavascriptIsolate = Due[Index].Component->JavascriptIsolate;
+				auto isolate = Context->JavascriptContext->isolate();
+
+				// Enter each isolate once
+				Isolate::Scope isolate_scope(isolate);
+				HandleScope handle_scope(isolate);
+
+				while (Index < Due.Num() && Due[Index].Component->JavascriptIsolate == JavascriptIsolate)
+				{
+					Context = Due[Index].Context;
+
+					Components.Reset();
+					DeltaTimes.Reset();
+					for (; Index < Due.Num() && Due[Index].Context == Context; ++Index)
+					{
+						Components.Add(Due[Index].Component);
+						DeltaTimes.Add(Due[Index].DeltaTime);
+					}
+
+					if (Context && Context->JavascriptContext.IsValid())
+					{
+						Context->JavascriptContext->DispatchTicks(Components, DeltaTimes);
+
+						INC_DWORD_STAT(STAT_JavascriptBatchedTickDispatches);
+					}
+				}
+			}
+
+			bTicking = false;
+		}
+
+		virtual FString DiagnosticMessage() override
+		{
+			return FString::Printf(TEXT("FJavascriptBatchedTickFunction[%d components]"), Entries.Num());
+		}
+	};
+
+	// World -> tick group -> tick function
+	TMap<TWeakObjectPtr<UWorld>, TMap<int32, FJavascriptBatchedTickFunction*>> Managers;
+
+	FDelegateHandle OnWorldCleanupHandle;
+
+	void DestroyTickFunction(FJavascriptBatchedTickFunction* TickFunction)
+	{
+		if (TickFunction->IsTickFunctionRegistered())
+		{
+			TickFunction->UnRegisterTickFunction();
+		}
+		delete TickFunction;
+	}
+
+	// Tick functions have to go before the level does
+	void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+	{
+		if (auto Groups = Managers.Find(World))
+		{
+			for (auto& Pair : *Groups)
+			{
+				DestroyTickFunction(Pair.Value);
+			}
+			Managers.Remove(World);
+		}
+	}
+}
+
+bool FJavascriptTickManager::Register(UJavascriptComponent* Component)
+{
+	auto World = Component->GetWorld();
+	if (!World || !World->PersistentLevel)
+	{
+		return false;
+	}
+
+	if (!OnWorldCleanupHandle.IsValid())
+	{
+		OnWorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddStatic(&OnWorldCleanup);
+	}
+
+	auto& TickFunction = Managers.FindOrAdd(World).FindOrAdd((int32)Component->PrimaryComponentTick.TickGroup);
+	if (!TickFunction)
+	{
+		TickFunction = new FJavascriptBatchedTickFunction;
+		TickFunction->World = World;
+		TickFunction->TickGroup = Component->PrimaryComponentTick.TickGroup;
+		TickFunction->bCanEverTick = true;
+		TickFunction->bTickEvenWhenPaused = true;
+		TickFunction->RegisterTickFunction(World->PersistentLevel);
+	}
+
+	TickFunction->Entries.Add({ Component, 0.0f });
+
+	return true;
+}
+
+void FJavascriptTickManager::Unregister(UJavascriptComponent* Component)
+{
+	for (auto It = Managers.CreateIterator(); It; ++It)
+	{
+		auto& Groups = It.Value();
+
+		for (auto GroupIt = Groups.CreateIterator(); GroupIt; ++GroupIt)
+		{
+			auto TickFunction = GroupIt.Value();
+
+			for (auto& Entry : TickFunction->Entries)
+			{
+				if (Entry.Component.Get() == Component)
+				{
+					// Entries are compacted on the next tick, which may be the current one
+					Entry.Component = nullptr;
+
+					if (!TickFunction->bTicking && TickFunction->IsEmpty())
+					{
+						DestroyTickFunction(TickFunction);
+						GroupIt.RemoveCurrent();
+
+						if (Groups.Num() == 0)
+						{
+							It.RemoveCurrent();
+						}
+					}
+					return;
+				}
+			}
+		}
+	}
+}
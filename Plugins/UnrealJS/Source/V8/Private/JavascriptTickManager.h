@@ -0,0 +1,16 @@
+#pragma once
+
+class UJavascriptComponent;
+
+/**
+ * Ticks UJavascriptComponents of a world in batches (see UJavascriptSettings::bBatchComponentTicks)
+ * There is one tick function per world and tick group. It enters each isolate once and calls OnTick listeners
+ * of all components which share a context with a single call into script.
+ * Component's tick group, TickInterval and tick enabled state are honored, its tick prerequisites are not.
+ */
+struct FJavascriptTickManager
+{
+	/** Returns false if the component can't be batched (no world yet), it should register its own tick function then */
+	static bool Register(UJavascriptComponent* Component);
+	static void Unregister(UJavascriptComponent* Component);
+};
@@ -0,0 +1,283 @@
+#include "V8PCH.h"
+#include "Translator.h"
+#include "Exception.h"
+#include "JavascriptTimers.h"
+#include "TypedArrays.h"
+
+using namespace v8;
+
+DECLARE_CYCLE_STAT(TEXT("Timers"), STAT_JavascriptTimers, STATGROUP_Javascript);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pending timers"), STAT_JavascriptPendingTimers, STATGROUP_Javascript);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Fired timers"), STAT_JavascriptFiredTimers, STATGROUP_Javascript);
+
+// Same clamp as HTML timers (and polyfill/windowTimers.js)
+static const uint64 MinInterval = 4;
+
+FJavascriptTimers::FJavascriptTimers(Isolate* InIsolate)
+	: isolate_(InIsolate), LastId(0), Time(0), NumNextTicks(0)
+{}
+
+FJavascriptTimers::~FJavascriptTimers()
+{
+	Reset();
+}
+
+void FJavascriptTimers::Reset()
+{
+	for (auto It = Timers.CreateIterator(); It; ++It)
+	{
+		Wheel.Cancel(It.Value());
+		delete It.Value();
+	}
+
+	DEC_DWORD_STAT_BY(STAT_JavascriptPendingTimers, Timers.Num());
+	Timers.Empty();
+
+	NextTicks.Reset();
+	NumNextTicks = 0;
+}
+
+void FJavascriptTimers::Expose(Local<Context> Context)
+{
+	auto global = Context->Global();
+	auto data = External::New(isolate_, this);
+
+	auto set_timeout = [](const FunctionCallbackInfo<Value>& info) { SetTimer(info, false); };
+	auto set_interval = [](const FunctionCallbackInfo<Value>& info) { SetTimer(info, true); };
+
+	global->Set(V8_KeywordString(isolate_, "setTimeout"), Function::New(isolate_, set_timeout, data));
+	global->Set(V8_KeywordString(isolate_, "setInterval"), Function::New(isolate_, set_interval, data));
+	global->Set(V8_KeywordString(isolate_, "clearTimeout"), Function::New(isolate_, ClearTimer, data));
+	global->Set(V8_KeywordString(isolate_, "clearInterval"), Function::New(isolate_, ClearTimer, data));
+
+	// process.nextTick, keep process if there is one already
+	auto process_name = V8_KeywordString(isolate_, "process");
+	auto process = global->Get(process_name);
+	if (!process->IsObject())
+	{
+		process = Object::New(isolate_);
+		global->Set(process_name, process);
+	}
+	process->ToObject()->Set(V8_KeywordString(isolate_, "nextTick"), Function::New(isolate_, NextTick, data));
+
+	// $time : seconds elapsed
+	auto time_getter = [](Local<String> property, const PropertyCallbackInfo<Value>& info) {
+		auto Self = reinterpret_cast<FJavascriptTimers*>(Local<External>::Cast(info.Data())->Value());
+		info.GetReturnValue().Set(Self->Time);
+	};
+
+	global->SetAccessor(V8_KeywordString(isolate_, "$time"), time_getter, 0, data);
+}
+
+void FJavascriptTimers::SetTimer(const FunctionCallbackInfo<Value>& info, bool bRepeat)
+{
+	auto isolate = info.GetIsolate();
+	auto Self = reinterpret_cast<FJavascriptTimers*>(Local<External>::Cast(info.Data())->Value());
+
+	if (info.Length() < 1)
+	{
+		isolate->ThrowException(Exception::TypeError(V8_String(isolate, "callback required")));
+		return;
+	}
+
+	// Browsers take delays beyond a signed 32 bit integer (Infinity too) as 1ms; NaN and negative ones as 0
+	double Delay = info.Length() > 1 ? info[1]->NumberValue() : 0;
+	if (!(Delay > 0))
+	{
+		Delay = 0;
+	}
+	else if (Delay > MAX_int32)
+	{
+		Delay = 1;
+	}
+
+	auto Timer = new FJavascriptTimer;
+	Timer->Id = ++Self->LastId;
+	Timer->Interval = bRepeat ? FMath::Max((uint64)Delay, MinInterval) : 0;
+
+	// Code strings are evaluated when fired, like browsers do
+	if (info[0]->IsFunction())
+	{
+		Timer->Callback.Reset(isolate, info[0]);
+	}
+	else
+	{
+		Timer->Callback.Reset(isolate, info[0]->ToString());
+	}
+
+	if (info.Length() > 2)
+	{
+		auto args = Array::New(isolate, info.Length() - 2);
+		for (int32 Index = 2; Index < info.Length(); ++Index)
+		{
+			args->Set(Index - 2, info[Index]);
+		}
+		Timer->Args.Reset(isolate, args);
+	}
+
+	Self->Timers.Add(Timer->Id, Timer);
+	Self->Wheel.Schedule(Timer, Self->Wheel.GetCurrentTick() + (uint64)Delay);
+
+	INC_DWORD_STAT(STAT_JavascriptPendingTimers);
+
+	info.GetReturnValue().Set(Timer->Id);
+}
+
+void FJavascriptTimers::ClearTimer(const FunctionCallbackInfo<Value>& info)
+{
+	auto Self = reinterpret_cast<FJavascriptTimers*>(Local<External>::Cast(info.Data())->Value());
+
+	if (info.Length() < 1 || !info[0]->IsNumber()) return;
+
+	FJavascriptTimer* Timer = nullptr;
+	if (Self->Timers.RemoveAndCopyValue(info[0]->Int32Value(), Timer))
+	{
+		Self->Wheel.Cancel(Timer);
+		delete Timer;
+
+		DEC_DWORD_STAT(STAT_JavascriptPendingTimers);
+	}
+}
+
+void FJavascriptTimers::NextTick(const FunctionCallbackInfo<Value>& info)
+{
+	auto isolate = info.GetIsolate();
+	auto Self = reinterpret_cast<FJavascriptTimers*>(Local<External>::Cast(info.Data())->Value());
+
+	if (info.Length() < 1 || !info[0]->IsFunction())
+	{
+		isolate->ThrowException(Exception::TypeError(V8_String(isolate, "callback is not a function")));
+		return;
+	}
+
+	if (Self->NextTicks.IsEmpty())
+	{
+		Self->NextTicks.Reset(isolate, Array::New(isolate));
+	}
+
+	Local<Value> args = Undefined(isolate);
+	if (info.Length() > 1)
+	{
+		auto arr = Array::New(isolate, info.Length() - 1);
+		for (int32 Index = 1; Index < info.Length(); ++Index)
+		{
+			arr->Set(Index - 1, info[Index]);
+		}
+		args = arr;
+	}
+
+	auto queue = Local<Array>::New(isolate, Self->NextTicks);
+	queue->Set(Self->NumNextTicks * 2, info[0]);
+	queue->Set(Self->NumNextTicks * 2 + 1, args);
+	Self->NumNextTicks++;
+}
+
+void FJavascriptTimers::Call(Local<Context> Context, Local<Value> Callback, Local<Value> Args)
+{
+	FTypedArrayViews::ValidateViews(Context->GetIsolate());
+
+	TryCatch try_catch;
+
+	if (Callback->IsFunction())
+	{
+		TArray<Local<Value>, TInlineAllocator<8>> argv;
+		if (Args->IsArray())
+		{
+			auto arr = Local<Array>::Cast(Args);
+			for (uint32_t Index = 0; Index < arr->Length(); ++Index)
+			{
+				argv.Add(arr->Get(Index));
+			}
+		}
+
+		Local<Function>::Cast(Callback)->Call(Context->Global(), argv.Num(), argv.GetData());
+	}
+	else
+	{
+		auto script = Script::Compile(Callback->ToString());
+		if (!script.IsEmpty())
+		{
+			script->Run();
+		}
+	}
+
+	if (try_catch.HasCaught())
+	{
+		FV8Exception::Report(try_catch);
+	}
+}
+
+// Callbacks queued while running are left to the next batch, so that a callback queueing itself can't hang the frame
+void FJavascriptTimers::RunNextTicks(Local<Context> Context)
+{
+	if (NumNextTicks)
+	{
+		auto queue = Local<Array>::New(isolate_, NextTicks);
+		auto Num = NumNextTicks;
+
+		NextTicks.Reset();
+		NumNextTicks = 0;
+
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			Call(Context, queue->Get(Index * 2), queue->Get(Index * 2 + 1));
+		}
+	}
+
+	isolate_->RunMicrotasks();
+}
+
+void FJavascriptTimers::Tick(Local<Context> Context, float DeltaSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_JavascriptTimers);
+
+	Time += DeltaSeconds;
+
+	RunNextTicks(Context);
+
+	Expired.Reset();
+	Wheel.Advance((uint64)(Time * 1000), Expired);
+
+	if (Expired.Num() == 0) return;
+
+	// Nodes may be deleted by clearTimeout while running, so go by id
+	TArray<int32, TInlineAllocator<64>> Ids;
+	for (auto Node : Expired)
+	{
+		Ids.Add(static_cast<FJavascriptTimer*>(Node)->Id);
+	}
+
+	for (auto Id : Ids)
+	{
+		auto Found = Timers.Find(Id);
+		if (!Found) continue;
+
+		auto Timer = *Found;
+		auto Callback = Local<Value>::New(isolate_, Timer->Callback);
+		auto Args = Timer->Args.IsEmpty() ? Local<Value>(Undefined(isolate_)) : Local<Value>(Local<Array>::New(isolate_, Timer->Args));
+
+		if (Timer->Interval == 0)
+		{
+			Timers.Remove(Id);
+			DEC_DWORD_STAT(STAT_JavascriptPendingTimers);
+
+			Call(Context, Callback, Args);
+
+			delete Timer;
+		}
+		else
+		{
+			Call(Context, Callback, Args);
+
+			// Still alive? Missed intervals aren't caught up
+			if (Timers.Contains(Id))
+			{
+				Wheel.Schedule(Timer, Timer->Expiry + Timer->Interval);
+			}
+		}
+
+		INC_DWORD_STAT(STAT_JavascriptFiredTimers);
+	}
+
+	RunNextTicks(Context);
+}
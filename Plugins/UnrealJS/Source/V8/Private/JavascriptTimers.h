@@ -0,0 +1,66 @@
+#pragma once
+
+#include "TimerWheel.h"
+
+struct FJavascriptTimer : FTimerWheelNode
+{
+	int32 Id;
+
+	// Milliseconds between calls, 0 for a timeout
+	uint64 Interval;
+
+	// Function or code to evaluate
+	v8::UniquePersistent<v8::Value> Callback;
+
+	// Extra arguments of setTimeout/setInterval
+	v8::UniquePersistent<v8::Array> Args;
+};
+
+/**
+ * setTimeout/setInterval/clearTimeout/clearInterval, process.nextTick and $time of a context.
+ * Ticked once per frame : process.nextTick callbacks run first, then due timers in order of expiry.
+ * Microtasks (Promise reactions) are drained after each batch.
+ */
+class FJavascriptTimers
+{
+public:
+	FJavascriptTimers(v8::Isolate* InIsolate);
+	~FJavascriptTimers();
+
+	/** Installs globals into the context */
+	void Expose(v8::Local<v8::Context> Context);
+
+	/** Isolate and context should be entered already */
+	void Tick(v8::Local<v8::Context> Context, float DeltaSeconds);
+
+	/** Cancels all timers and pending process.nextTick callbacks */
+	void Reset();
+
+	int32 Num() const
+	{
+		return Timers.Num();
+	}
+
+private:
+	static void SetTimer(const v8::FunctionCallbackInfo<v8::Value>& info, bool bRepeat);
+	static void ClearTimer(const v8::FunctionCallbackInfo<v8::Value>& info);
+	static void NextTick(const v8::FunctionCallbackInfo<v8::Value>& info);
+
+	void RunNextTicks(v8::Local<v8::Context> Context);
+	void Call(v8::Local<v8::Context> Context, v8::Local<v8::Value> Callback, v8::Local<v8::Value> Args);
+
+	v8::Isolate* isolate_;
+
+	FTimerWheel Wheel;
+	TMap<int32, FJavascriptTimer*> Timers;
+	int32 LastId;
+
+	// Seconds since the context has been created, advanced by Tick
+	double Time;
+
+	// [function, arguments, ...] queued by process.nextTick
+	v8::UniquePersistent<v8::Array> NextTicks;
+	int32 NumNextTicks;
+
+	TArray<FTimerWheelNode*> Expired;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+/**
+ * Native copy of TArray<UObject*>/TArray<FStruct> which is handed to Javascript as an array-like object.
+ * Elements are wrapped on first access through an indexed interceptor and cached thereafter.
+ *
+ * Internal fields of the Javascript object:
+ *  0 : nullptr (so that RawMemoryFromV8 never mistakes it for an UObject or a struct instance)
+ *  1 : FLazyArray*
+ *  2 : cache of wrapped elements (Array)
+ */
+struct FLazyArray
+{
+	enum { NumInternalFields = 3 };
+
+	UArrayProperty* Property;
+	FScriptArray Array;
+
+	// Weak handle to the Javascript object, deletes this when collected
+	v8::UniquePersistent<v8::Object> Handle;
+
+	static bool CanBeLazy(UArrayProperty* Property)
+	{
+		return Property->Inner->IsA<UObjectProperty>() || Property->Inner->IsA<UStructProperty>();
+	}
+
+	FLazyArray(UArrayProperty* InProperty, const void* Source)
+		: Property(InProperty)
+	{
+		Property->CopyCompleteValue(&Array, Source);
+	}
+
+	~FLazyArray()
+	{
+		Property->DestroyValue(&Array);
+	}
+
+	int32 Num() const
+	{
+		return Array.Num();
+	}
+
+	uint8* GetRawPtr(int32 Index)
+	{
+		FScriptArrayHelper Helper(Property, &Array);
+		return Helper.GetRawPtr(Index);
+	}
+
+	// Objects stay alive as long as the array does, like exported objects do
+	void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+	{
+		if (Property->Inner->IsA<UObjectProperty>())
+		{
+			for (int32 Index = 0; Index < Num(); ++Index)
+			{
+				Collector.AddReferencedObject(*(UObject**)GetRawPtr(Index), InThis);
+			}
+		}
+	}
+
+	static FLazyArray* FromV8(v8::Local<v8::Object> Object)
+	{
+		return reinterpret_cast<FLazyArray*>(Object->GetAlignedPointerFromInternalField(1));
+	}
+};
@@ -3,6 +3,14 @@
 class FMallocArrayBufferAllocator : public v8::ArrayBuffer::Allocator
 {
 public:
+	FMallocArrayBufferAllocator()
+		: NumAllocations(0), AllocatedBytes(0)
+	{}
+
+	// Live allocations (for stats)
+	int32 NumAllocations;
+	int64 AllocatedBytes;
+
 	/**
 	* Allocate |length| bytes. Return NULL if allocation is not successful.
 	* Memory should be initialized to zeroes.
@@ -11,6 +19,7 @@ public:
 	{
 		auto buffer = GMalloc->Malloc(length);
 		FMemory::Memzero(buffer, length);
+		Track(length);
 		return buffer;
 	}
 
@@ -20,6 +29,7 @@ public:
 	*/
 	virtual void* AllocateUninitialized(size_t length)
 	{
+		Track(length);
 		return GMalloc->Malloc(length);
 	}
 	/**
@@ -29,5 +39,19 @@ public:
 	virtual void Free(void* data, size_t length)
 	{
 		GMalloc->Free(data);
+		Untrack(length);
+	}
+
+protected:
+	void Track(size_t length)
+	{
+		FPlatformAtomics::InterlockedIncrement(&NumAllocations);
+		FPlatformAtomics::InterlockedAdd(&AllocatedBytes, (int64)length);
+	}
+
+	void Untrack(size_t length)
+	{
+		FPlatformAtomics::InterlockedDecrement(&NumAllocations);
+		FPlatformAtomics::InterlockedAdd(&AllocatedBytes, -(int64)length);
 	}
 };
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "V8PCH.h"
+#include "ModuleResolver.h"
+#include "ScriptBundle.h"
+#include "DirectoryWatcherModule.h"
+#include "IDirectoryWatcher.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Module stat cache hits"), STAT_JavascriptModuleStatHits, STATGROUP_Javascript);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Module stat cache misses"), STAT_JavascriptModuleStatMisses, STATGROUP_Javascript);
+
+namespace
+{
+	TMap<FString, bool> Files;
+	TMap<FString, bool> Directories;
+	TMap<FString, FString> PackageMains;
+	uint32 Generation = 1;
+
+	// Watched directory -> handle
+	TMap<FString, FDelegateHandle> Watched;
+
+	template <typename Fn>
+	bool Cached(TMap<FString, bool>& Cache, const FString& Path, Fn&& Query)
+	{
+		if (auto Found = Cache.Find(Path))
+		{
+			INC_DWORD_STAT(STAT_JavascriptModuleStatHits);
+			return *Found;
+		}
+
+		INC_DWORD_STAT(STAT_JavascriptModuleStatMisses);
+		return Cache.Add(Path, Query());
+	}
+}
+
+bool FJavascriptModuleResolver::FileExists(const FString& Filename)
+{
+	return Cached(Files, Filename, [&]{
+		return FJavascriptScriptBundle::Covers(Filename) ? FJavascriptScriptBundle::FileExists(Filename) : IFileManager::Get().FileSize(*Filename) != INDEX_NONE;
+	});
+}
+
+bool FJavascriptModuleResolver::DirectoryExists(const FString& Directory)
+{
+	return Cached(Directories, Directory, [&]{
+		return FJavascriptScriptBundle::Covers(Directory) ? FJavascriptScriptBundle::DirectoryExists(Directory) : FPaths::DirectoryExists(Directory);
+	});
+}
+
+bool FJavascriptModuleResolver::FindPackageMain(const FString& Directory, FString& OutMain)
+{
+	if (auto Found = PackageMains.Find(Directory))
+	{
+		OutMain = *Found;
+		return true;
+	}
+	return false;
+}
+
+void FJavascriptModuleResolver::AddPackageMain(const FString& Directory, const FString& Main)
+{
+	PackageMains.Add(Directory, Main);
+}
+
+uint32 FJavascriptModuleResolver::GetGeneration()
+{
+	return Generation;
+}
+
+void FJavascriptModuleResolver::Invalidate()
+{
+	Files.Empty();
+	Directories.Empty();
+	PackageMains.Empty();
+	Generation++;
+}
+
+void FJavascriptModuleResolver::Watch(const FString& InDirectory)
+{
+	auto Directory = FPaths::ConvertRelativePathToFull(InDirectory);
+	FPaths::NormalizeDirectoryName(Directory);
+
+	// Covered already?
+	for (auto It = Watched.CreateConstIterator(); It; ++It)
+	{
+		if (Directory == It.Key() || Directory.StartsWith(It.Key() + TEXT("/")))
+		{
+			return;
+		}
+	}
+
+	if (!IFileManager::Get().DirectoryExists(*Directory)) return;
+
+	FDirectoryWatcherModule& DirectoryWatcherModule = FModuleManager::Get().LoadModuleChecked<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+	IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule.Get();
+	if (!DirectoryWatcher) return;
+
+	auto Changed = IDirectoryWatcher::FDirectoryChanged::CreateLambda([](const TArray<FFileChangeData>& FileChanges) {
+		Invalidate();
+	});
+
+	FDelegateHandle Handle;
+	DirectoryWatcher->RegisterDirectoryChangedCallback_Handle(Directory, Changed, Handle, true);
+
+	Watched.Add(Directory, Handle);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+/**
+ * File system queries made by require(), cached across contexts.
+ * Script search paths are watched, any change within them flushes the cache and bumps the generation,
+ * which invalidates resolution caches of contexts as well.
+ * Paths packed into the script bundle are answered by the bundle.
+ */
+struct FJavascriptModuleResolver
+{
+	static bool FileExists(const FString& Filename);
+	static bool DirectoryExists(const FString& Directory);
+
+	/** "main" of Directory/package.json, false if it hasn't been looked up yet (empty when there is none) */
+	static bool FindPackageMain(const FString& Directory, FString& OutMain);
+	static void AddPackageMain(const FString& Directory, const FString& Main);
+
+	/** Bumped whenever the cache is flushed */
+	static uint32 GetGeneration();
+
+	/** Flushes the cache when anything changes within Directory (recursively) */
+	static void Watch(const FString& Directory);
+
+	static void Invalidate();
+};
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "MallocArrayBufferAllocator.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("ArrayBuffer pool hits"), STAT_JavascriptArrayBufferPoolHits, STATGROUP_Javascript, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("ArrayBuffer pool misses"), STAT_JavascriptArrayBufferPoolMisses, STATGROUP_Javascript, );
+
+/**
+ * ArrayBuffer allocator which keeps freed small blocks in size-class free lists (16 bytes .. 4KB, powers of two).
+ *
+ * One instance belongs to one isolate. V8 may still free backing stores off the thread which runs scripts
+ * (and pool size can be changed from anywhere), so free lists are guarded by a lock, uncontended in practice.
+ *
+ * Reused blocks are cleared only up to the requested length, and AllocateUninitialized skips clearing at all.
+ * Blocks larger than the biggest size class bypass the pool and go straight to FMemory; zeroed ones through MallocZeroed,
+ * so that an allocator which hands out fresh (already zeroed) pages doesn't have to touch them.
+ */
+class FPooledArrayBufferAllocator : public FMallocArrayBufferAllocator
+{
+public:
+	enum
+	{
+		MinClassSizeLog2 = 4,
+		MaxClassSizeLog2 = 12,
+		NumClasses = MaxClassSizeLog2 - MinClassSizeLog2 + 1,
+		MaxPooledSize = 1 << MaxClassSizeLog2
+	};
+
+	struct FSizeClass
+	{
+		FSizeClass() : FreeList(nullptr), NumFree(0), NumAllocs(0), NumFrees(0), NumHits(0) {}
+
+		void* FreeList;
+		int32 NumFree;
+
+		int32 NumAllocs;
+		int32 NumFrees;
+		int32 NumHits;
+	};
+
+	FPooledArrayBufferAllocator()
+		: MaxBytesHeld(0), BytesHeld(0)
+	{}
+
+	~FPooledArrayBufferAllocator()
+	{
+		Trim();
+	}
+
+	/** Upper limit of memory kept in free lists, 0 disables pooling */
+	void SetMaxBytesHeld(int32 InMaxBytesHeld)
+	{
+		FScopeLock Lock(&FreeListLock);
+
+		MaxBytesHeld = FMath::Max(InMaxBytesHeld, 0);
+		if (BytesHeld > MaxBytesHeld)
+		{
+			Trim();
+		}
+	}
+
+	virtual void* Allocate(size_t length) override
+	{
+		if (length > MaxPooledSize)
+		{
+			Track(length);
+			return FMemory::MallocZeroed(length);
+		}
+
+		auto Block = AllocateFromClass(length);
+		FMemory::Memzero(Block, length);
+		return Block;
+	}
+
+	virtual void* AllocateUninitialized(size_t length) override
+	{
+		if (length > MaxPooledSize)
+		{
+			Track(length);
+			return FMemory::Malloc(length);
+		}
+
+		return AllocateFromClass(length);
+	}
+
+	virtual void Free(void* data, size_t length) override
+	{
+		Untrack(length);
+
+		if (length > MaxPooledSize)
+		{
+			FMemory::Free(data);
+			return;
+		}
+
+		FScopeLock Lock(&FreeListLock);
+
+		auto ClassIndex = GetClassIndex(length);
+		auto& Class = Classes[ClassIndex];
+		auto ClassSize = GetClassSize(ClassIndex);
+
+		Class.NumFrees++;
+
+		if (BytesHeld + ClassSize > MaxBytesHeld)
+		{
+			FMemory::Free(data);
+			return;
+		}
+
+		// Free blocks form an intrusive singly linked list
+		*(void**)data = Class.FreeList;
+		Class.FreeList = data;
+		Class.NumFree++;
+		BytesHeld += ClassSize;
+	}
+
+	/** Returns all pooled blocks to FMemory */
+	void Trim()
+	{
+		FScopeLock Lock(&FreeListLock);
+
+		for (int32 ClassIndex = 0; ClassIndex < NumClasses; ++ClassIndex)
+		{
+			auto& Class = Classes[ClassIndex];
+			while (Class.FreeList)
+			{
+				auto Next = *(void**)Class.FreeList;
+				FMemory::Free(Class.FreeList);
+				Class.FreeList = Next;
+			}
+			Class.NumFree = 0;
+		}
+		BytesHeld = 0;
+	}
+
+	static int32 GetClassSize(int32 ClassIndex)
+	{
+		return 1 << (ClassIndex + MinClassSizeLog2);
+	}
+
+	const FSizeClass& GetClass(int32 ClassIndex) const
+	{
+		return Classes[ClassIndex];
+	}
+
+	int32 GetBytesHeld() const
+	{
+		return BytesHeld;
+	}
+
+private:
+	static int32 GetClassIndex(size_t length)
+	{
+		return FMath::Max<int32>((int32)FMath::CeilLogTwo((uint32)length), MinClassSizeLog2) - MinClassSizeLog2;
+	}
+
+	void* AllocateFromClass(size_t length)
+	{
+		Track(length);
+
+		FScopeLock Lock(&FreeListLock);
+
+		auto ClassIndex = GetClassIndex(length);
+		auto& Class = Classes[ClassIndex];
+
+		Class.NumAllocs++;
+
+		if (Class.FreeList)
+		{
+			auto Block = Class.FreeList;
+			Class.FreeList = *(void**)Block;
+			Class.NumFree--;
+			Class.NumHits++;
+			BytesHeld -= GetClassSize(ClassIndex);
+			INC_DWORD_STAT(STAT_JavascriptArrayBufferPoolHits);
+			return Block;
+		}
+
+		INC_DWORD_STAT(STAT_JavascriptArrayBufferPoolMisses);
+		return FMemory::Malloc(GetClassSize(ClassIndex));
+	}
+
+	FCriticalSection FreeListLock;
+
+	FSizeClass Classes[NumClasses];
+
+	int32 MaxBytesHeld;
+	int32 BytesHeld;
+};
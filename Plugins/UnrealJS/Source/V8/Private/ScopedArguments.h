@@ -1,26 +1,20 @@
 #pragma once
 
+#include "CallPlan.h"
+
 struct FScopedArguments
 {
-	FScopedArguments(UFunction* InFunction, uint8* InBuffer)
-	: Function(InFunction), Buffer(InBuffer)
+	FScopedArguments(const FJavascriptCallPlan& InPlan, uint8* InBuffer)
+	: Plan(InPlan), Buffer(InBuffer)
 	{
-		for (TFieldIterator<UProperty> It(Function); It && (It->PropertyFlags & CPF_Parm) == CPF_Parm; ++It)
-		{
-			auto Prop = *It;
-			Prop->InitializeValue_InContainer(Buffer);
-		}
+		Plan.InitializeParams(Buffer);
 	}
 
 	~FScopedArguments()
 	{
-		for (TFieldIterator<UProperty> It(Function); It && (It->PropertyFlags & CPF_Parm) == CPF_Parm; ++It)
-		{
-			auto Prop = *It;
-			Prop->DestroyValue_InContainer(Buffer);
-		}
+		Plan.DestroyParams(Buffer);
 	}
 
-	UFunction* Function;
+	const FJavascriptCallPlan& Plan;
 	uint8* Buffer;
 };
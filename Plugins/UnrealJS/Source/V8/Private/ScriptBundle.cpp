@@ -0,0 +1,410 @@
+#include "V8PCH.h"
+#include "ScriptBundle.h"
+#include "CodeCache.h"
+#include "AsyncScriptLoader.h"
+#include "MallocArrayBufferAllocator.h"
+#include "JavascriptSettings.h"
+#include "Translator.h"
+#include "IV8.h"
+
+using namespace v8;
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Bundled script reads"), STAT_JavascriptBundleReads, STATGROUP_Javascript);
+
+static const uint32 BundleMagicNumber = 0x4a53424e;
+static const uint32 BundleFormatVersion = 1;
+
+namespace
+{
+	enum class EBundleEncoding : uint8
+	{
+		Latin1,
+		UTF8
+	};
+
+	struct FBundleEntry
+	{
+		// Index of the search path
+		int32 Root;
+
+		// Relative to the search path
+		FString Path;
+
+		uint8 Encoding;
+		uint32 Offset;
+		uint32 Length;
+
+		// Code cache of the source wrapped as a module, tagged with its content hash
+		uint32 CacheOffset;
+		uint32 CacheLength;
+		FString CacheHash;
+
+		FBundleEntry()
+			: Root(0), Encoding(0), Offset(0), Length(0), CacheOffset(0), CacheLength(0)
+		{}
+
+		friend FArchive& operator << (FArchive& Ar, FBundleEntry& Entry)
+		{
+			Ar << Entry.Root;
+			Ar << Entry.Path;
+			Ar << Entry.Encoding;
+			Ar << Entry.Offset;
+			Ar << Entry.Length;
+			Ar << Entry.CacheOffset;
+			Ar << Entry.CacheLength;
+			Ar << Entry.CacheHash;
+			return Ar;
+		}
+	};
+
+	// Whole file, index and data are used in place
+	TArray<uint8> Buffer;
+	const uint8* Data = nullptr;
+	TArray<FBundleEntry> Entries;
+
+	// Packed search paths (full, with trailing slash)
+	TArray<FString> Roots;
+
+	// Full path -> entry
+	TMap<FString, int32> Files;
+	TSet<FString> Directories;
+
+	// Content hash -> entry
+	TMap<FString, int32> Caches;
+
+	bool bMounted = false;
+	bool bAvailable = false;
+
+	FString NormalizePath(const FString& Path)
+	{
+		auto FullPath = Path;
+		FPaths::NormalizeFilename(FullPath);
+		FullPath = FPaths::ConvertRelativePathToFull(FullPath);
+		FPaths::NormalizeDirectoryName(FullPath);
+		return FullPath;
+	}
+
+	void Decode(const FBundleEntry& Entry, FString& OutText)
+	{
+		auto Source = Data + Entry.Offset;
+
+		if (Entry.Encoding == (uint8)EBundleEncoding::Latin1)
+		{
+			// Widening only
+			auto& Chars = OutText.GetCharArray();
+			Chars.Empty(Entry.Length + 1);
+			Chars.AddUninitialized(Entry.Length + 1);
+			for (uint32 Index = 0; Index < Entry.Length; ++Index)
+			{
+				Chars[Index] = (TCHAR)Source[Index];
+			}
+			Chars[Entry.Length] = 0;
+		}
+		else
+		{
+			FUTF8ToTCHAR Converted((const ANSICHAR*)Source, Entry.Length);
+			OutText = FString(Converted.Length(), Converted.Get());
+		}
+	}
+
+	void Encode(const FString& Text, FBundleEntry& OutEntry, TArray<uint8>& OutData)
+	{
+		bool bLatin1 = true;
+		for (auto Char : Text.GetCharArray())
+		{
+			if ((uint32)Char > 0xff)
+			{
+				bLatin1 = false;
+				break;
+			}
+		}
+
+		OutEntry.Offset = OutData.Num();
+
+		if (bLatin1)
+		{
+			OutEntry.Encoding = (uint8)EBundleEncoding::Latin1;
+			OutEntry.Length = Text.Len();
+
+			auto Dest = OutData.AddUninitialized(Text.Len());
+			for (int32 Index = 0; Index < Text.Len(); ++Index)
+			{
+				OutData[Dest + Index] = (uint8)Text[Index];
+			}
+		}
+		else
+		{
+			FTCHARToUTF8 Utf8(*Text);
+
+			OutEntry.Encoding = (uint8)EBundleEncoding::UTF8;
+			OutEntry.Length = Utf8.Length();
+			OutData.Append((const uint8*)Utf8.Get(), Utf8.Length());
+		}
+	}
+}
+
+FString FJavascriptScriptBundle::GetBundleFilename()
+{
+	return FPaths::GameContentDir() / GetDefault<UJavascriptSettings>()->ScriptBundleFile;
+}
+
+bool FJavascriptScriptBundle::Build(const TArray<FString>& Paths, bool bCodeCache)
+{
+	TArray<int32> PackedRoots;
+	TArray<FString> PackedPaths;
+	TArray<FBundleEntry> NewEntries;
+	TArray<uint8> NewData;
+
+	// Bare isolate, only to produce code cache
+	FMallocArrayBufferAllocator Allocator;
+	Isolate* isolate = nullptr;
+	if (bCodeCache)
+	{
+		Isolate::CreateParams params;
+		params.array_buffer_allocator = &Allocator;
+		isolate = Isolate::New(params);
+	}
+
+	int32 NumCached = 0;
+
+	for (int32 RootIndex = 0; RootIndex < Paths.Num(); ++RootIndex)
+	{
+		auto Root = NormalizePath(Paths[RootIndex]);
+
+		// Same directory as another search path, which has been packed already
+		if (PackedPaths.Contains(Root) || !IFileManager::Get().DirectoryExists(*Root)) continue;
+
+		PackedRoots.Add(RootIndex);
+		PackedPaths.Add(Root);
+
+		TArray<FString> Found;
+		IFileManager::Get().FindFilesRecursive(Found, *Root, TEXT("*.js"), true, false);
+		IFileManager::Get().FindFilesRecursive(Found, *Root, TEXT("package.json"), true, false, false);
+
+		for (const auto& File : Found)
+		{
+			FString Text;
+			if (!FFileHelper::LoadFileToString(Text, *File))
+			{
+				UE_LOG(Javascript, Error, TEXT("Script bundle : failed to read %s"), *File);
+				return false;
+			}
+
+			FBundleEntry Entry;
+			Entry.Root = RootIndex;
+			Entry.Path = NormalizePath(File).Mid(Root.Len() + 1);
+			Encode(Text, Entry, NewData);
+
+			// Modules are compiled wrapped by require, so is the cache
+			if (isolate && File.EndsWith(TEXT(".js")))
+			{
+				Isolate::Scope isolate_scope(isolate);
+				HandleScope handle_scope(isolate);
+
+				auto Wrapped = WrapModuleSource(Text);
+
+				TryCatch try_catch;
+				ScriptCompiler::Source source(V8_String(isolate, Wrapped));
+
+				Local<UnboundScript> script;
+				if (ScriptCompiler::CompileUnboundScript(isolate, &source, ScriptCompiler::kProduceCodeCache).ToLocal(&script) && source.GetCachedData())
+				{
+					auto CachedData = source.GetCachedData();
+
+					Entry.CacheOffset = NewData.Num();
+					Entry.CacheLength = CachedData->length;
+					Entry.CacheHash = FJavascriptCodeCache::GetContentHash(Wrapped);
+					NewData.Append(CachedData->data, CachedData->length);
+
+					NumCached++;
+				}
+				else
+				{
+					UE_LOG(Javascript, Warning, TEXT("Script bundle : %s doesn't compile, packed without code cache"), *File);
+				}
+			}
+
+			NewEntries.Add(Entry);
+		}
+	}
+
+	if (isolate)
+	{
+		isolate->Dispose();
+	}
+
+	auto Filename = GetBundleFilename();
+	TScopedPointer<FArchive> Ar(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!Ar.IsValid())
+	{
+		UE_LOG(Javascript, Error, TEXT("Failed to write script bundle : %s"), *Filename);
+		return false;
+	}
+
+	uint32 Magic = BundleMagicNumber, FormatVersion = BundleFormatVersion, VersionTag = ScriptCompiler::CachedDataVersionTag();
+	*Ar << Magic;
+	*Ar << FormatVersion;
+	*Ar << VersionTag;
+	*Ar << PackedRoots;
+	*Ar << NewEntries;
+	Ar->Serialize(NewData.GetData(), NewData.Num());
+
+	UE_LOG(Javascript, Log, TEXT("Script bundle saved : %s (%d KB, %d scripts, %d with code cache)"), *Filename, NewData.Num() / 1024, NewEntries.Num(), NumCached);
+
+	return true;
+}
+
+bool FJavascriptScriptBundle::Mount()
+{
+	if (bMounted) return bAvailable;
+
+	bMounted = true;
+
+	// Loose files stay authoritative in the editor, unless asked for
+	if (!GetDefault<UJavascriptSettings>()->bUseScriptBundle || !(FPlatformProperties::RequiresCookedData() || FParse::Param(FCommandLine::Get(), TEXT("ScriptBundle"))))
+	{
+		return false;
+	}
+
+	// One open, one read
+	auto Filename = GetBundleFilename();
+	if (!FFileHelper::LoadFileToArray(Buffer, *Filename, FILEREAD_Silent))
+	{
+		UE_LOG(Javascript, Log, TEXT("Script bundle not found : %s"), *Filename);
+		return false;
+	}
+
+	FMemoryReader Reader(Buffer);
+
+	uint32 Magic = 0, FormatVersion = 0, VersionTag = 0;
+	TArray<int32> PackedRoots;
+	Reader << Magic;
+	Reader << FormatVersion;
+
+	if (Magic != BundleMagicNumber || FormatVersion != BundleFormatVersion)
+	{
+		UE_LOG(Javascript, Warning, TEXT("Script bundle is stale, rebuild it with JavascriptBundle commandlet : %s"), *Filename);
+		Buffer.Empty();
+		return false;
+	}
+
+	Reader << VersionTag;
+	Reader << PackedRoots;
+	Reader << Entries;
+
+	Data = Buffer.GetData() + Reader.Tell();
+	const int64 DataSize = Buffer.Num() - Reader.Tell();
+
+	// Code cache is rejected by V8 anyway, skip it
+	const bool bValidCache = VersionTag == ScriptCompiler::CachedDataVersionTag();
+	if (!bValidCache)
+	{
+		UE_LOG(Javascript, Log, TEXT("Script bundle : code cache is stale, ignored"));
+	}
+
+	// Search paths are matched by position, V8Module sets them up in the same order everywhere
+	auto Paths = IV8::Get().GetGlobalScriptSearchPaths();
+
+	Roots.Empty();
+	Roots.AddDefaulted(Paths.Num());
+	for (auto RootIndex : PackedRoots)
+	{
+		if (Paths.IsValidIndex(RootIndex))
+		{
+			Roots[RootIndex] = NormalizePath(Paths[RootIndex]);
+			Directories.Add(Roots[RootIndex]);
+		}
+	}
+
+	for (int32 Index = 0; Index < Entries.Num(); ++Index)
+	{
+		const auto& Entry = Entries[Index];
+		if (!Roots.IsValidIndex(Entry.Root) || Roots[Entry.Root].IsEmpty()) continue;
+
+		if ((int64)Entry.Offset + Entry.Length > DataSize || (int64)Entry.CacheOffset + Entry.CacheLength > DataSize)
+		{
+			UE_LOG(Javascript, Warning, TEXT("Script bundle is corrupted : %s"), *Filename);
+			return false;
+		}
+
+		const auto& Root = Roots[Entry.Root];
+		auto FullPath = Root / Entry.Path;
+		Files.Add(FullPath, Index);
+
+		for (auto Directory = FPaths::GetPath(FullPath); Directory.Len() > Root.Len() && !Directories.Contains(Directory); Directory = FPaths::GetPath(Directory))
+		{
+			Directories.Add(Directory);
+		}
+
+		if (bValidCache && Entry.CacheLength)
+		{
+			Caches.Add(Entry.CacheHash, Index);
+		}
+	}
+
+	// Root paths are kept with trailing slash for prefix matching
+	for (auto& Root : Roots)
+	{
+		if (!Root.IsEmpty())
+		{
+			Root.Append(TEXT("/"));
+		}
+	}
+
+	UE_LOG(Javascript, Log, TEXT("Script bundle mounted : %s (%d KB, %d scripts)"), *Filename, Buffer.Num() / 1024, Files.Num());
+
+	bAvailable = true;
+	return true;
+}
+
+bool FJavascriptScriptBundle::Covers(const FString& Path)
+{
+	if (!bAvailable) return false;
+
+	auto FullPath = NormalizePath(Path) + TEXT("/");
+	for (const auto& Root : Roots)
+	{
+		if (!Root.IsEmpty() && FullPath.StartsWith(Root))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FJavascriptScriptBundle::FileExists(const FString& Filename)
+{
+	return Files.Contains(NormalizePath(Filename));
+}
+
+bool FJavascriptScriptBundle::DirectoryExists(const FString& Directory)
+{
+	return Directories.Contains(NormalizePath(Directory));
+}
+
+bool FJavascriptScriptBundle::LoadFileToString(FString& OutText, const FString& Filename)
+{
+	if (!Covers(Filename))
+	{
+		return FFileHelper::LoadFileToString(OutText, *Filename);
+	}
+
+	auto Found = Files.Find(NormalizePath(Filename));
+	if (!Found) return false;
+
+	Decode(Entries[*Found], OutText);
+
+	INC_DWORD_STAT(STAT_JavascriptBundleReads);
+	return true;
+}
+
+bool FJavascriptScriptBundle::FindCodeCache(const FString& ContentHash, const uint8*& OutData, int32& OutLength)
+{
+	auto Found = Caches.Find(ContentHash);
+	if (!Found) return false;
+
+	const auto& Entry = Entries[*Found];
+	OutData = Data + Entry.CacheOffset;
+	OutLength = Entry.CacheLength;
+	return true;
+}
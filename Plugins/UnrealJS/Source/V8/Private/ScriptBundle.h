@@ -0,0 +1,31 @@
+#pragma once
+
+/**
+ * Script bundle : every script under the global script search paths packed into a single file at cook time
+ * (JavascriptBundle commandlet), for packaged builds where opening many small files is slow.
+ * It holds a path index, sources in Latin-1 (or UTF-8 when they need it) and optional code cache of modules.
+ * Once mounted, the bundle is authoritative for the search paths it has packed : files and directories under them
+ * are looked up within the index only. Other paths go to the file system as usual.
+ */
+struct FJavascriptScriptBundle
+{
+	/** Packs scripts under Paths into GetBundleFilename(), producing code cache if bCodeCache */
+	static bool Build(const TArray<FString>& Paths, bool bCodeCache);
+
+	/** Loads the bundle on first call (game thread), returns false if there is none to use */
+	static bool Mount();
+
+	/** Whether Path is under a packed search path. If so, the answers below are final. */
+	static bool Covers(const FString& Path);
+
+	static bool FileExists(const FString& Filename);
+	static bool DirectoryExists(const FString& Directory);
+
+	/** Reads from the bundle if it covers Filename, from the file system otherwise. Safe on any thread once mounted. */
+	static bool LoadFileToString(FString& OutText, const FString& Filename);
+
+	/** Code cache for the script whose content hash is ContentHash (see FJavascriptCodeCache::GetContentHash) */
+	static bool FindCodeCache(const FString& ContentHash, const uint8*& OutData, int32& OutLength);
+
+	static FString GetBundleFilename();
+};
@@ -0,0 +1,109 @@
+#include "V8PCH.h"
+#include "StringCache.h"
+#include "Translator.h"
+
+using namespace v8;
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Keyword cache hits"), STAT_JavascriptKeywordCacheHits, STATGROUP_Javascript);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Keyword cache misses"), STAT_JavascriptKeywordCacheMisses, STATGROUP_Javascript);
+
+FJavascriptStringCache::FJavascriptStringCache(Isolate* InIsolate)
+	: NumHits(0), NumMisses(0), isolate_(InIsolate)
+{
+	isolate_->SetData(DataSlot, this);
+}
+
+FJavascriptStringCache::~FJavascriptStringCache()
+{
+	Empty();
+
+	isolate_->SetData(DataSlot, nullptr);
+}
+
+Local<String> FJavascriptStringCache::Found(const UniquePersistent<String>& Handle)
+{
+	NumHits++;
+	INC_DWORD_STAT(STAT_JavascriptKeywordCacheHits);
+
+	return Local<String>::New(isolate_, Handle);
+}
+
+Local<String> FJavascriptStringCache::Add(UniquePersistent<String>& Handle, Local<String> String)
+{
+	NumMisses++;
+	INC_DWORD_STAT(STAT_JavascriptKeywordCacheMisses);
+
+	Handle.Reset(isolate_, String);
+	return String;
+}
+
+void FJavascriptStringCache::TrimIfNeeded()
+{
+	if (Num() >= MaxEntries)
+	{
+		Names.Empty();
+		Strings.Empty();
+	}
+}
+
+Local<String> FJavascriptStringCache::Keyword(FName Name)
+{
+	const auto Key = GetNameKey(Name);
+
+	if (auto Handle = Names.Find(Key))
+	{
+		return Found(*Handle);
+	}
+
+	TrimIfNeeded();
+
+	return Add(Names.Add(Key), V8_InternalizedString(isolate_, Name.ToString()));
+}
+
+Local<String> FJavascriptStringCache::Keyword(const FString& InString)
+{
+	if (auto Handle = Strings.Find(InString))
+	{
+		return Found(*Handle);
+	}
+
+	TrimIfNeeded();
+
+	return Add(Strings.Add(InString), V8_InternalizedString(isolate_, InString));
+}
+
+Local<String> FJavascriptStringCache::Keyword(const char* InString)
+{
+	auto Literal = Literals.Find(InString);
+	if (Literal && FCStringAnsi::Strcmp(Literal->Text.GetData(), InString) == 0)
+	{
+		return Found(Literal->Handle);
+	}
+
+	if (!Literal)
+	{
+		if (Literals.Num() >= MaxEntries)
+		{
+			Literals.Empty();
+		}
+
+		Literal = &Literals.Add(InString);
+	}
+
+	Literal->Text.SetNumUninitialized(FCStringAnsi::Strlen(InString) + 1);
+	FMemory::Memcpy(Literal->Text.GetData(), InString, Literal->Text.Num());
+
+	return Add(Literal->Handle, String::NewFromUtf8(isolate_, InString, String::kInternalizedString));
+}
+
+void FJavascriptStringCache::Empty()
+{
+	Names.Empty();
+	Strings.Empty();
+	Literals.Empty();
+}
+
+int32 FJavascriptStringCache::Num() const
+{
+	return Names.Num() + Strings.Num() + Literals.Num();
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+/**
+ * Per-isolate cache of internalized V8 strings for keys which are looked up over and over
+ * (property/parameter names, enum names, static ASCII literals)
+ * Lives in isolate data slot (FJavascriptStringCache::DataSlot), so V8_KeywordString can find it.
+ */
+class FJavascriptStringCache
+{
+public:
+	enum { DataSlot = 1 };
+
+	// Dynamic keys are dropped all together once the cache grows beyond this
+	enum { MaxEntries = 16384 };
+
+	FJavascriptStringCache(v8::Isolate* InIsolate);
+	~FJavascriptStringCache();
+
+	static FJavascriptStringCache* Get(v8::Isolate* isolate)
+	{
+		return reinterpret_cast<FJavascriptStringCache*>(isolate->GetData(DataSlot));
+	}
+
+	v8::Local<v8::String> Keyword(FName Name);
+	v8::Local<v8::String> Keyword(const FString& String);
+	v8::Local<v8::String> Keyword(const char* String);
+
+	// Release all handles (should be done before isolate is disposed)
+	void Empty();
+
+	int32 Num() const;
+
+	uint32 NumHits;
+	uint32 NumMisses;
+
+private:
+	struct FCaseSensitiveKeyFuncs : TDefaultMapKeyFuncs<FString, v8::UniquePersistent<v8::String>, false>
+	{
+		static bool Matches(const FString& A, const FString& B)
+		{
+			return A.Equals(B, ESearchCase::CaseSensitive);
+		}
+
+		static uint32 GetKeyHash(const FString& Key)
+		{
+			return FCrc::StrCrc32(*Key);
+		}
+	};
+
+	struct FLiteral
+	{
+		// Copy of literal to guard against non-static buffers which reuse an address
+		TArray<ANSICHAR> Text;
+		v8::UniquePersistent<v8::String> Handle;
+	};
+
+	v8::Local<v8::String> Found(const v8::UniquePersistent<v8::String>& Handle);
+	v8::Local<v8::String> Add(v8::UniquePersistent<v8::String>& Handle, v8::Local<v8::String> String);
+	void TrimIfNeeded();
+
+	v8::Isolate* isolate_;
+
+	// FName compares case-insensitively, so names are keyed by their case-preserving display index and number
+	static uint64 GetNameKey(FName Name)
+	{
+		return ((uint64)(uint32)Name.GetDisplayIndex() << 32) | (uint32)Name.GetNumber();
+	}
+
+	TMap<uint64, v8::UniquePersistent<v8::String>> Names;
+	TMap<FString, v8::UniquePersistent<v8::String>, FDefaultSetAllocator, FCaseSensitiveKeyFuncs> Strings;
+	TMap<const char*, FLiteral> Literals;
+};
@@ -27,7 +27,7 @@ struct FStructMemoryInstance
 	: public TSharedFromThis<FStructMemoryInstance>
 {
 	FStructMemoryInstance(UScriptStruct* InStruct, const IPropertyOwner& InOwner, void* InSource)
-	: Struct(InStruct), Source(InSource)
+	: Struct(InStruct), Source(InSource), ReportedIsolate(nullptr)
 	{
 		Owner = InOwner.Owner;
 		if (Owner == EPropertyOwner::Object)
@@ -67,6 +67,21 @@ struct FStructMemoryInstance
 		{
 			Struct->DestroyStruct(GetMemory());
 		}
+
+		if (ReportedIsolate)
+		{
+			ReportedIsolate->AdjustAmountOfExternalAllocatedMemory(-(int64_t)Buffer.Num());
+		}
+	}
+
+	// Let V8 know about our own buffer, so that it can take it into account for GC heuristics
+	void ReportExternalMemory(v8::Isolate* isolate)
+	{
+		if (Owner == EPropertyOwner::None && !ReportedIsolate)
+		{
+			ReportedIsolate = isolate;
+			ReportedIsolate->AdjustAmountOfExternalAllocatedMemory(Buffer.Num());
+		}
 	}
 
 	// Struct 
@@ -87,6 +102,9 @@ struct FStructMemoryInstance
 	// Independent memory buffer
 	TArray<uint8> Buffer;
 
+	// Isolate which has been told about Buffer
+	v8::Isolate* ReportedIsolate;
+
 	uint8* GetMemory()
 	{
 		if (Owner == EPropertyOwner::None)
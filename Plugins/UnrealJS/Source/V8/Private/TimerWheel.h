@@ -0,0 +1,157 @@
+#pragma once
+
+struct FTimerWheelNode
+{
+	uint64 Expiry;
+	FTimerWheelNode* Prev;
+	FTimerWheelNode* Next;
+
+	FTimerWheelNode() : Expiry(0), Prev(nullptr), Next(nullptr) {}
+
+	bool IsScheduled() const
+	{
+		return Prev != nullptr;
+	}
+};
+
+/**
+ * Hierarchical timing wheel, 4 levels of 64 slots (2^24 ticks, about 4.6 hours at 1ms per tick)
+ * Nodes are linked into slots intrusively, so that Schedule and Cancel are O(1).
+ * A slot of an upper level is cascaded into lower levels when the lower level wraps around.
+ * Nodes further than the wheel can hold are parked in the last level and placed again on cascade.
+ */
+class FTimerWheel
+{
+public:
+	enum { NumLevels = 4, SlotBits = 6, NumSlots = 1 << SlotBits, SlotMask = NumSlots - 1 };
+
+	FTimerWheel()
+		: CurrentTick(0), NumScheduled(0)
+	{
+		for (int32 Level = 0; Level < NumLevels; ++Level)
+		{
+			for (int32 Slot = 0; Slot < NumSlots; ++Slot)
+			{
+				auto& Head = Slots[Level][Slot];
+				Head.Prev = Head.Next = &Head;
+			}
+		}
+	}
+
+	uint64 GetCurrentTick() const
+	{
+		return CurrentTick;
+	}
+
+	int32 Num() const
+	{
+		return NumScheduled;
+	}
+
+	/** Expires at Expiry, or on the next tick if it is due already */
+	void Schedule(FTimerWheelNode* Node, uint64 Expiry)
+	{
+		Cancel(Node);
+
+		Node->Expiry = FMath::Max(Expiry, CurrentTick + 1);
+		Place(Node);
+
+		NumScheduled++;
+	}
+
+	void Cancel(FTimerWheelNode* Node)
+	{
+		if (Node->IsScheduled())
+		{
+			Unlink(Node);
+
+			NumScheduled--;
+		}
+	}
+
+	/** Moves up to Tick, expired nodes are appended to OutExpired in order of expiry */
+	void Advance(uint64 Tick, TArray<FTimerWheelNode*>& OutExpired)
+	{
+		while (CurrentTick < Tick)
+		{
+			// Nothing to visit
+			if (NumScheduled == 0)
+			{
+				CurrentTick = Tick;
+				break;
+			}
+
+			CurrentTick++;
+
+			// Upper levels first, their nodes may land in the slot we are about to visit
+			int32 TopLevel = 0;
+			while (TopLevel < NumLevels - 1 && (CurrentTick & ((uint64(1) << (SlotBits * (TopLevel + 1))) - 1)) == 0)
+			{
+				TopLevel++;
+			}
+
+			for (int32 Level = TopLevel; Level > 0; --Level)
+			{
+				Cascade(Level, (CurrentTick >> (SlotBits * Level)) & SlotMask);
+			}
+
+			auto& Head = Slots[0][CurrentTick & SlotMask];
+			while (Head.Next != &Head)
+			{
+				auto Node = Head.Next;
+				Unlink(Node);
+				NumScheduled--;
+
+				OutExpired.Add(Node);
+			}
+		}
+	}
+
+private:
+	void Place(FTimerWheelNode* Node)
+	{
+		uint64 Delta = Node->Expiry - CurrentTick;
+		uint64 Expiry = Node->Expiry;
+
+		int32 Level = 0;
+		while (Level < NumLevels - 1 && Delta >= (uint64(1) << (SlotBits * (Level + 1))))
+		{
+			Level++;
+		}
+
+		// Park at the far end, it will be placed again when cascaded
+		if (Delta >= (uint64(1) << (SlotBits * NumLevels)))
+		{
+			Expiry = CurrentTick + (uint64(1) << (SlotBits * NumLevels)) - 1;
+		}
+
+		auto& Head = Slots[Level][(Expiry >> (SlotBits * Level)) & SlotMask];
+		Node->Prev = Head.Prev;
+		Node->Next = &Head;
+		Head.Prev->Next = Node;
+		Head.Prev = Node;
+	}
+
+	void Unlink(FTimerWheelNode* Node)
+	{
+		Node->Prev->Next = Node->Next;
+		Node->Next->Prev = Node->Prev;
+		Node->Prev = Node->Next = nullptr;
+	}
+
+	void Cascade(int32 Level, uint64 Slot)
+	{
+		auto& Head = Slots[Level][Slot];
+		while (Head.Next != &Head)
+		{
+			auto Node = Head.Next;
+			Unlink(Node);
+			Place(Node);
+		}
+	}
+
+	FTimerWheelNode Slots[NumLevels][NumSlots];
+
+	uint64 CurrentTick;
+	int32 NumScheduled;
+};
@@ -1,5 +1,31 @@
 #include "V8PCH.h"
 #include "Translator.h"
+#include "StringCache.h"
+#include "MallocArrayBufferAllocator.h"
+
+// Strings at least this long are handed over to V8 by V8_ExternalString
+static const int32 ExternalStringMinLength = 1024;
+
+/** FString owned by an external V8 string, disposed by V8 when the string is collected */
+class FExternalStringResource : public v8::String::ExternalStringResource
+{
+public:
+	FExternalStringResource(FString&& InText)
+		: Text(MoveTemp(InText))
+	{}
+
+	virtual const uint16_t* data() const override
+	{
+		return reinterpret_cast<const uint16_t*>(*Text);
+	}
+
+	virtual size_t length() const override
+	{
+		return Text.Len();
+	}
+
+	FString Text;
+};
 
 namespace v8
 {
@@ -66,9 +92,58 @@ namespace v8
 		return nullptr;
 	}
 
+	// TCHAR is UTF-16 on Windows : copied as is, V8 stores it as one-byte if it can.
+	// Elsewhere, Latin-1 is narrowed and anything else goes through UTF-8.
+	static Local<String> NewString(Isolate* isolate, const FString& String, String::NewStringType Type)
+	{
+		if (sizeof(TCHAR) == sizeof(uint16_t))
+		{
+			return String::NewFromTwoByte(isolate, reinterpret_cast<const uint16_t*>(*String), Type, String.Len());
+		}
+
+		TArray<uint8, TInlineAllocator<256>> Chars;
+		Chars.AddUninitialized(String.Len());
+		for (int32 Index = 0; Index < String.Len(); ++Index)
+		{
+			if ((uint32)String[Index] > 0xff)
+			{
+				return String::NewFromUtf8(isolate, TCHAR_TO_UTF8(*String), Type);
+			}
+			Chars[Index] = (uint8)String[Index];
+		}
+		return String::NewFromOneByte(isolate, Chars.GetData(), Type, Chars.Num());
+	}
+
 	Local<String> V8_String(Isolate* isolate, const FString& String)
 	{
-		return String::NewFromUtf8(isolate, TCHAR_TO_UTF8(*String));
+		return NewString(isolate, String, String::kNormalString);
+	}
+
+	Local<String> V8_InternalizedString(Isolate* isolate, const FString& String)
+	{
+		return NewString(isolate, String, String::kInternalizedString);
+	}
+
+	Local<String> V8_ExternalString(Isolate* isolate, FString&& String, const FString*& OutText)
+	{
+		if (sizeof(TCHAR) == sizeof(uint16_t) && String.Len() >= ExternalStringMinLength)
+		{
+			auto Resource = new FExternalStringResource(MoveTemp(String));
+
+			Local<v8::String> Result;
+			if (String::NewExternalTwoByte(isolate, Resource).ToLocal(&Result))
+			{
+				OutText = &Resource->Text;
+				return Result;
+			}
+
+			// Too long, not taken over
+			String = MoveTemp(Resource->Text);
+			delete Resource;
+		}
+
+		OutText = &String;
+		return V8_String(isolate, String);
 	}
 
 	Local<String> V8_String(Isolate* isolate, const char* String)
@@ -78,17 +153,71 @@ namespace v8
 
 	Local<String> V8_KeywordString(Isolate* isolate, const FString& String)
 	{
-		return String::NewFromUtf8(isolate, TCHAR_TO_UTF8(*String), String::kInternalizedString);
+		if (auto Cache = FJavascriptStringCache::Get(isolate))
+		{
+			return Cache->Keyword(String);
+		}
+
+		return V8_InternalizedString(isolate, String);
 	}
 
 	Local<String> V8_KeywordString(Isolate* isolate, const char* String)
 	{
+		if (auto Cache = FJavascriptStringCache::Get(isolate))
+		{
+			return Cache->Keyword(String);
+		}
+
 		return String::NewFromUtf8(isolate, String, String::kInternalizedString);
 	}
 
+	Local<String> V8_KeywordString(Isolate* isolate, FName Name)
+	{
+		if (auto Cache = FJavascriptStringCache::Get(isolate))
+		{
+			return Cache->Keyword(Name);
+		}
+
+		return V8_InternalizedString(isolate, Name.ToString());
+	}
+
+	// Written straight into FString's buffer, V8 widens one-byte strings while copying
 	FString StringFromV8(Local<Value> Value)
 	{
-		return UTF8_TO_TCHAR(*String::Utf8Value(Value));
+		if (Value.IsEmpty()) return FString();
+
+		auto str = Value->ToString();
+		if (str.IsEmpty()) return FString();
+
+		auto Length = str->Length();
+		if (Length == 0) return FString();
+
+		FString Result;
+		auto& Chars = Result.GetCharArray();
+		Chars.AddUninitialized(Length + 1);
+
+		if (sizeof(TCHAR) == sizeof(uint16_t))
+		{
+			str->Write(reinterpret_cast<uint16_t*>(Chars.GetData()), 0, Length, String::NO_NULL_TERMINATION);
+		}
+		else if (str->ContainsOnlyOneByte())
+		{
+			TArray<uint8, TInlineAllocator<256>> Bytes;
+			Bytes.AddUninitialized(Length);
+			str->WriteOneByte(Bytes.GetData(), 0, Length, String::NO_NULL_TERMINATION);
+
+			for (int32 Index = 0; Index < Length; ++Index)
+			{
+				Chars[Index] = Bytes[Index];
+			}
+		}
+		else
+		{
+			return UTF8_TO_TCHAR(*String::Utf8Value(str));
+		}
+
+		Chars[Length] = 0;
+		return Result;
 	}
 
 	FString StringFromArgs(const FunctionCallbackInfo<v8::Value>& args, int StartIndex)
@@ -104,4 +233,88 @@ namespace v8
 
 		return FString::Join(ArgStrings, TEXT(" "));
 	}
-}
\ No newline at end of file
+}
+
+using namespace v8;
+
+static void BenchmarkStrings(const TArray<FString>& Args)
+{
+	int32 Iterations = FMath::Max(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 100000, 1);
+
+	FMallocArrayBufferAllocator Allocator;
+	Isolate::CreateParams params;
+	params.array_buffer_allocator = &Allocator;
+	auto isolate = Isolate::New(params);
+
+	{
+		Isolate::Scope isolate_scope(isolate);
+		HandleScope handle_scope(isolate);
+
+		// Per-string cost (ns) of the previous UTF-8 round trip and the direct one
+		auto Measure = [&](const FString& Text, int32 Count) {
+			double Times[4];
+
+			double StartTime = FPlatformTime::Seconds();
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				HandleScope scope(isolate);
+				String::NewFromUtf8(isolate, TCHAR_TO_UTF8(*Text));
+			}
+			Times[0] = (FPlatformTime::Seconds() - StartTime) * 1e9 / Count;
+
+			StartTime = FPlatformTime::Seconds();
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				HandleScope scope(isolate);
+				V8_String(isolate, Text);
+			}
+			Times[1] = (FPlatformTime::Seconds() - StartTime) * 1e9 / Count;
+
+			auto str = V8_String(isolate, Text);
+
+			StartTime = FPlatformTime::Seconds();
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				FString Result = UTF8_TO_TCHAR(*String::Utf8Value(str));
+			}
+			Times[2] = (FPlatformTime::Seconds() - StartTime) * 1e9 / Count;
+
+			StartTime = FPlatformTime::Seconds();
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				FString Result = StringFromV8(str);
+			}
+			Times[3] = (FPlatformTime::Seconds() - StartTime) * 1e9 / Count;
+
+			UE_LOG(Javascript, Log, TEXT("%d chars : to V8 %.1fns (utf8 %.1fns), from V8 %.1fns (utf8 %.1fns)"), Text.Len(), Times[1], Times[0], Times[3], Times[2]);
+		};
+
+		FString Short = TEXT("RootComponent");
+		FString Long;
+		while (Long.Len() < 64 * 1024)
+		{
+			Long.Append(TEXT("var module = { exports : {} }; // \uac00\n"));
+		}
+
+		Measure(Short, Iterations);
+		Measure(Long, FMath::Max(Iterations / 1000, 1));
+
+		// Script source handed over as is
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < Iterations / 1000; ++Index)
+		{
+			HandleScope scope(isolate);
+			const FString* Text = nullptr;
+			V8_ExternalString(isolate, FString(Long), Text);
+		}
+		UE_LOG(Javascript, Log, TEXT("%d chars : external (including FString copy) %.1fns"), Long.Len(), (FPlatformTime::Seconds() - StartTime) * 1e9 / FMath::Max(Iterations / 1000, 1));
+	}
+
+	isolate->Dispose();
+}
+
+static FAutoConsoleCommand BenchmarkStringsCommand(
+	TEXT("Javascript.BenchmarkStrings"),
+	TEXT("Measures per-string cost of FString/V8 string marshalling for short and long strings. Usage: Javascript.BenchmarkStrings [Iterations]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkStrings)
+	);
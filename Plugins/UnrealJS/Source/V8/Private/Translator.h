@@ -27,8 +27,12 @@ namespace v8
 	void ReportException(Isolate* isolate, TryCatch& try_catch);
 	Local<String> V8_String(Isolate* isolate, const FString& String);
 	Local<String> V8_String(Isolate* isolate, const char* String);
+	Local<String> V8_InternalizedString(Isolate* isolate, const FString& String);
+	/** Takes over String, long ones are referenced by V8 without copying (ie. script sources). OutText is valid as long as the result is alive. */
+	Local<String> V8_ExternalString(Isolate* isolate, FString&& String, const FString*& OutText);
 	Local<String> V8_KeywordString(Isolate* isolate, const FString& String);
 	Local<String> V8_KeywordString(Isolate* isolate, const char* String);
+	Local<String> V8_KeywordString(Isolate* isolate, FName Name);
 	FString StringFromV8(Local<Value> Value);
 	void CallJavascriptFunction(Handle<Context> context, Handle<Value> This, UFunction* SignatureFunction, Handle<Function> func, void* Parms);
 	UClass* UClassFromV8(Isolate* isolate_, Local<Value> Value);
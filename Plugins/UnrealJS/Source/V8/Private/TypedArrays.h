@@ -0,0 +1,250 @@
+#pragma once
+
+#include "StructMemoryInstance.h"
+#include "JavascriptSettings.h"
+
+/**
+ * TArray<float>, TArray<int32>, TArray<uint8> and TArray<uint16> as typed arrays
+ *
+ * Copy : a new ArrayBuffer filled by a single memcpy. Always safe.
+ * View : an externalized ArrayBuffer over FScriptArray's allocation. No copy at all, writes go straight into the TArray.
+ *
+ * A view is only handed out when the array lives in an object or a struct instance which can be tracked.
+ * Function parameters/return values are always copied. A view is neutered (length becomes 0) when
+ *  - the owning object or struct instance has gone,
+ *  - the TArray has been reallocated or resized (checked after every native call from Javascript, on property write
+ *    and whenever native code calls into Javascript),
+ *  - the frame ends. Views are frame-scoped, so read the property again in the next frame.
+ */
+struct FTypedArrays
+{
+	static bool IsNumeric(UProperty* Inner)
+	{
+		if (auto p = Cast<UByteProperty>(Inner))
+		{
+			return p->Enum == nullptr;
+		}
+
+		return Inner->IsA<UFloatProperty>() || Inner->IsA<UIntProperty>() || Inner->IsA<UUInt16Property>();
+	}
+
+	static bool IsMatchingTypedArray(UProperty* Inner, v8::Local<v8::Value> Value)
+	{
+		if (Inner->IsA<UFloatProperty>()) return Value->IsFloat32Array();
+		if (Inner->IsA<UIntProperty>()) return Value->IsInt32Array();
+		if (Inner->IsA<UUInt16Property>()) return Value->IsUint16Array();
+		if (Inner->IsA<UByteProperty>()) return Value->IsUint8Array() || Value->IsUint8ClampedArray();
+		return false;
+	}
+
+	static v8::Local<v8::Value> New(UProperty* Inner, v8::Local<v8::ArrayBuffer> Buffer, int32 Num)
+	{
+		if (Inner->IsA<UFloatProperty>()) return v8::Float32Array::New(Buffer, 0, Num);
+		if (Inner->IsA<UIntProperty>()) return v8::Int32Array::New(Buffer, 0, Num);
+		if (Inner->IsA<UUInt16Property>()) return v8::Uint16Array::New(Buffer, 0, Num);
+		return v8::Uint8Array::New(Buffer, 0, Num);
+	}
+
+	static v8::Local<v8::Value> Copy(v8::Isolate* isolate, UArrayProperty* Property, FScriptArrayHelper& Helper)
+	{
+		auto Num = Helper.Num();
+		auto Bytes = Num * Property->Inner->ElementSize;
+		auto Buffer = v8::ArrayBuffer::New(isolate, Bytes);
+
+		if (Bytes)
+		{
+			FMemory::Memcpy(Buffer->GetContents().Data(), Helper.GetRawPtr(0), Bytes);
+		}
+
+		return New(Property->Inner, Buffer, Num);
+	}
+
+	// Resize and memcpy from a typed array of matching element type
+	static void Write(UArrayProperty* Property, FScriptArrayHelper& Helper, v8::Local<v8::Value> Value)
+	{
+		auto View = v8::Local<v8::ArrayBufferView>::Cast(Value);
+		auto ElementSize = Property->Inner->ElementSize;
+		auto Num = (int32)(View->ByteLength() / ElementSize);
+		auto Bytes = Num * ElementSize;
+
+		// Source may be a view over this very array, which Resize below could reallocate or shrink
+		auto Source = (uint8*)View->Buffer()->GetContents().Data() + View->ByteOffset();
+		auto Begin = Helper.Num() ? Helper.GetRawPtr(0) : nullptr;
+		auto End = Begin + Helper.Num() * ElementSize;
+
+		if (Bytes && Source < End && Source + Bytes > Begin)
+		{
+			// Nothing to do for the view of whole array
+			if (Source == Begin && Num == Helper.Num()) return;
+
+			TArray<uint8> Temp;
+			Temp.Append(Source, Bytes);
+
+			Helper.Resize(Num);
+			FMemory::Memcpy(Helper.GetRawPtr(0), Temp.GetData(), Bytes);
+			return;
+		}
+
+		Helper.Resize(Num);
+
+		if (Num)
+		{
+			View->CopyContents(Helper.GetRawPtr(0), Bytes);
+		}
+	}
+};
+
+struct FTypedArrayView
+{
+	v8::UniquePersistent<v8::ArrayBuffer> Buffer;
+	v8::UniquePersistent<v8::Value> Array;
+
+	FWeakObjectPtr Object;
+	TWeakPtr<FStructMemoryInstance> Memory;
+	bool bHasMemory;
+
+	void* Data;
+	int32 Num;
+
+	bool IsValid(const FScriptArray* ScriptArray) const
+	{
+		if (bHasMemory)
+		{
+			auto Pinned = Memory.Pin();
+			if (!Pinned.IsValid() || Pinned->GetMemory() == nullptr)
+			{
+				return false;
+			}
+		}
+		else if (!Object.IsValid())
+		{
+			return false;
+		}
+
+		return ScriptArray->GetData() == Data && ScriptArray->Num() == Num;
+	}
+};
+
+class FTypedArrayViews
+{
+public:
+	enum { DataSlot = 3 };
+
+	FTypedArrayViews(v8::Isolate* InIsolate)
+		: isolate_(InIsolate)
+	{
+		isolate_->SetData(DataSlot, this);
+	}
+
+	~FTypedArrayViews()
+	{
+		isolate_->SetData(DataSlot, nullptr);
+	}
+
+	/** To be called whenever native code enters Javascript (it may have reallocated arrays since) */
+	static void ValidateViews(v8::Isolate* isolate)
+	{
+		if (auto Self = reinterpret_cast<FTypedArrayViews*>(isolate->GetData(DataSlot)))
+		{
+			Self->Validate();
+		}
+	}
+
+	v8::Local<v8::Value> Get(UArrayProperty* Property, uint8* Buffer, const IPropertyOwner& Owner)
+	{
+		auto ScriptArray = Property->GetPropertyValuePtr_InContainer(Buffer);
+
+		if (auto Existing = Views.Find(ScriptArray))
+		{
+			if (Existing->IsValid(ScriptArray))
+			{
+				return v8::Local<v8::Value>::New(isolate_, Existing->Array);
+			}
+
+			Neuter(*Existing);
+			Views.Remove(ScriptArray);
+		}
+
+		FScriptArrayHelper Helper(Property, ScriptArray);
+		if (Helper.Num() == 0 || Owner.Owner == EPropertyOwner::None)
+		{
+			return FTypedArrays::Copy(isolate_, Property, Helper);
+		}
+
+		auto Bytes = Helper.Num() * Property->Inner->ElementSize;
+		auto ArrayBuffer = v8::ArrayBuffer::New(isolate_, Helper.GetRawPtr(0), Bytes, v8::ArrayBufferCreationMode::kExternalized);
+		auto Array = FTypedArrays::New(Property->Inner, ArrayBuffer, Helper.Num());
+
+		auto& View = Views.Add(ScriptArray);
+		View.Buffer.Reset(isolate_, ArrayBuffer);
+		View.Array.Reset(isolate_, Array);
+		View.bHasMemory = Owner.Owner == EPropertyOwner::Memory;
+		if (View.bHasMemory)
+		{
+			View.Memory = ((const FStructMemoryPropertyOwner&)Owner).Memory->AsShared();
+		}
+		else
+		{
+			View.Object = ((const FObjectPropertyOwner&)Owner).Object;
+		}
+		View.Data = Helper.GetRawPtr(0);
+		View.Num = Helper.Num();
+
+		return Array;
+	}
+
+	// Neuter views whose TArray has been reallocated/resized or whose owner has gone
+	void Validate()
+	{
+		if (Views.Num() == 0) return;
+
+		v8::HandleScope handle_scope(isolate_);
+
+		for (auto It = Views.CreateIterator(); It; ++It)
+		{
+			if (!It.Value().IsValid(It.Key()))
+			{
+				Neuter(It.Value());
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	// Views don't survive the frame
+	void NeuterAll()
+	{
+		if (Views.Num() == 0) return;
+
+		v8::Isolate::Scope isolate_scope(isolate_);
+		v8::HandleScope handle_scope(isolate_);
+
+		for (auto It = Views.CreateIterator(); It; ++It)
+		{
+			Neuter(It.Value());
+		}
+
+		Views.Empty();
+	}
+
+	int32 Num() const
+	{
+		return Views.Num();
+	}
+
+private:
+	void Neuter(FTypedArrayView& View)
+	{
+		auto ArrayBuffer = v8::Local<v8::ArrayBuffer>::New(isolate_, View.Buffer);
+		if (ArrayBuffer->IsNeuterable())
+		{
+			ArrayBuffer->Neuter();
+		}
+
+		View.Buffer.Reset();
+		View.Array.Reset();
+	}
+
+	v8::Isolate* isolate_;
+
+	TMap<FScriptArray*, FTypedArrayView> Views;
+};
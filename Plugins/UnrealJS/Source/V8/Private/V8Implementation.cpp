@@ -2,6 +2,7 @@
 #include "JavascriptIsolate.h"
 #include "JavascriptContext.h"
 #include "JavascriptComponent.h"
+#include "JavascriptSettings.h"
 #include "Config.h"
 #include "Translator.h"
 #include "Exception.h"
@@ -11,6 +12,9 @@
 
 using namespace v8;
 
+#include "StructMemoryInstance.h"
+#include "TypedArrays.h"
+
 DEFINE_LOG_CATEGORY(Javascript);
 
 UJavascriptIsolate::UJavascriptIsolate(const FObjectInitializer& ObjectInitializer)
@@ -53,6 +57,88 @@ UJavascriptContext* UJavascriptIsolate::CreateContext()
 	return NewObject<UJavascriptContext>(this);
 }
 
+void UJavascriptIsolate::ForceGC()
+{
+	if (JavascriptIsolate.IsValid())
+	{
+		JavascriptIsolate->ForceGC();
+	}
+}
+
+void UJavascriptIsolate::SetArrayBufferPoolSize(int32 SizeKB)
+{
+	if (JavascriptIsolate.IsValid())
+	{
+		JavascriptIsolate->SetArrayBufferPoolSize(SizeKB);
+	}
+}
+
+FJavascriptIsolateStats UJavascriptIsolate::GetStats()
+{
+	FJavascriptIsolateStats Stats;
+
+	if (JavascriptIsolate.IsValid())
+	{
+		JavascriptIsolate->GetStats(Stats);
+
+		// Contexts are created with this isolate as their outer
+		for (TObjectIterator<UJavascriptContext> It; It; ++It)
+		{
+			if (It->GetOuter() != this || !It->JavascriptContext.IsValid()) continue;
+
+			auto Context = It->JavascriptContext;
+			Stats.NumContexts++;
+			Stats.NumObjectWrappers += Context->ObjectToObjectMap.Num();
+			Stats.NumStructInstances += Context->MemoryToObjectMap.Num();
+
+			for (auto Memory = Context->MemoryToObjectMap.CreateConstIterator(); Memory; ++Memory)
+			{
+				Stats.StructInstanceBytes += Memory.Key()->Buffer.Num();
+			}
+		}
+	}
+
+	return Stats;
+}
+
+static void DumpJavascriptStats(const TArray<FString>& Args)
+{
+	for (TObjectIterator<UJavascriptIsolate> It; It; ++It)
+	{
+		if (It->HasAnyFlags(RF_ClassDefaultObject)) continue;
+
+		auto Stats = It->GetStats();
+		UE_LOG(Javascript, Log, TEXT("%s: %d context(s), %d object wrapper(s), %d struct instance(s) (%d bytes), %d ArrayBuffer(s) (%d bytes), %d class/%d struct template(s), heap %d/%d KB"),
+			*It->GetName(),
+			Stats.NumContexts,
+			Stats.NumObjectWrappers,
+			Stats.NumStructInstances, Stats.StructInstanceBytes,
+			Stats.NumArrayBuffers, Stats.ArrayBufferBytes,
+			Stats.NumClassTemplates, Stats.NumStructTemplates,
+			Stats.UsedHeapSizeKB, Stats.TotalHeapSizeKB);
+
+		if (Stats.ArrayBufferPoolHits + Stats.ArrayBufferPoolMisses > 0)
+		{
+			UE_LOG(Javascript, Log, TEXT("  ArrayBuffer pool: %.1f%% hits, %d bytes held"),
+				100.0f * Stats.ArrayBufferPoolHits / (Stats.ArrayBufferPoolHits + Stats.ArrayBufferPoolMisses),
+				Stats.ArrayBufferPoolBytes);
+
+			for (int32 Index = 0; Index < Stats.ArrayBufferPoolAllocs.Num(); ++Index)
+			{
+				if (Stats.ArrayBufferPoolAllocs[Index] == 0) continue;
+
+				UE_LOG(Javascript, Log, TEXT("    %5d bytes : %d allocs, %d frees"), 16 << Index, Stats.ArrayBufferPoolAllocs[Index], Stats.ArrayBufferPoolFrees[Index]);
+			}
+		}
+	}
+}
+
+static FAutoConsoleCommand GJavascriptStatsCommand(
+	TEXT("Javascript.Stats"),
+	TEXT("Dumps memory usage of all Javascript isolates"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&DumpJavascriptStats)
+	);
+
 UJavascriptContext::UJavascriptContext(const FObjectInitializer& ObjectInitializer)
 : Super(ObjectInitializer)
 {
@@ -109,6 +195,21 @@ void UJavascriptContext::RunFile(FString Filename)
 	JavascriptContext->Public_RunFile(Filename);
 }
 
+void UJavascriptContext::RunFileAsync(FString Filename)
+{
+	JavascriptContext->Public_RunFileAsync(Filename);
+}
+
+void UJavascriptContext::Preload(TArray<FString> Modules)
+{
+	JavascriptContext->Preload(Modules.Num() ? Modules : GetDefault<UJavascriptSettings>()->PreloadModules);
+}
+
+int32 UJavascriptContext::GetNumPendingLoads() const
+{
+	return JavascriptContext->GetNumPendingLoads();
+}
+
 FString UJavascriptContext::RunScript(FString Script, bool bOutput)
 {
 	return JavascriptContext->Public_RunScript(Script, bOutput);	
@@ -144,151 +245,235 @@ bool UJavascriptContext::CallProxyFunction(UObject* Holder, UObject* This, UFunc
 	return JavascriptContext->CallProxyFunction(Holder, This, FunctionToCall, Parms);
 }
 
-namespace fastcall
+static FJavascriptCallFrame& CurrentFrame(FJavascriptContext* Context)
 {
-	enum { MaxArgs = 32 };
+	return Context->CallFrames[Context->CallDepth - 1];
+}
 
-	Handle<Value> argv[MaxArgs];
-	Handle<Value> retval;
-	int argc = 0;
+static void PushArgument(FJavascriptContext* Context, Local<Value> Value)
+{
+	auto& Frame = CurrentFrame(Context);
+	check(Frame.Argc < FJavascriptCallFrame::MaxArgs);
+	Frame.Argv[Frame.Argc++] = Value;
+}
 
-	void push(Local<Value> value)
-	{
-		argv[argc++] = value;
-	}
+static Local<Value> PopReturnValue(FJavascriptContext* Context)
+{
+	return CurrentFrame(Context).ReturnValue;
+}
 
-	void call(Local<Object> self, Local<Function> func)
-	{
-		retval = func->Call(self, argc, argv);
-	}
+static bool CallFunction(FJavascriptContext* Context, Local<Function> func)
+{
+	auto& Frame = CurrentFrame(Context);
 
-	void reset()
-	{
-		for (int32 Index = 0; Index < argc; ++Index)
-		{
-			argv[Index].Clear();
-		}
-		argc = 0;
-		retval.Clear();
-	}
-	
-	uint8 handle_scope_raw[sizeof(HandleScope)];
+	FTypedArrayViews::ValidateViews(Context->isolate());
 
-	void enter(Isolate* isolate)
-	{
-		isolate->Enter();
-		new(reinterpret_cast<HandleScope*>(handle_scope_raw)) HandleScope(isolate);
-	}
+	TryCatch try_catch;
 
-	void exit(Isolate* isolate)
-	{
-		reinterpret_cast<HandleScope*>(handle_scope_raw)->~HandleScope();
-		isolate->Exit();		
-	}
+	Frame.ReturnValue = func->Call(Context->context()->Global(), Frame.Argc, Frame.Argv);
 
-	void enter(Local<Context> context)
+	if (try_catch.HasCaught())
 	{
-		context->Enter();
+		FV8Exception::Report(try_catch);
+		return false;
 	}
-
-	void exit(Local<Context> context)
+	else
 	{
-		context->Exit();		
+		return true;
 	}
 }
 
 void UJavascriptContext::InternalPushArgument(int32 Value)
 {
 	auto isolate = JavascriptContext->isolate();
-	fastcall::push(Int32::New(isolate, Value));
+	PushArgument(JavascriptContext.Get(), Int32::New(isolate, Value));
 }
 
 void UJavascriptContext::InternalPushArgument(float Value)
 {
 	auto isolate = JavascriptContext->isolate();
-	fastcall::push(Number::New(isolate, Value));
+	PushArgument(JavascriptContext.Get(), Number::New(isolate, Value));
 }
 
 void UJavascriptContext::InternalPushArgument(bool Value)
 {
 	auto isolate = JavascriptContext->isolate();
-	fastcall::push(Boolean::New(isolate, Value));
+	PushArgument(JavascriptContext.Get(), Boolean::New(isolate, Value));
 }
 
 void UJavascriptContext::InternalPushArgument(const TCHAR* Value)
 {
 	auto isolate = JavascriptContext->isolate();
-	fastcall::push(V8_String(isolate,Value));
+	PushArgument(JavascriptContext.Get(), V8_String(isolate, Value));
 }
 
 void UJavascriptContext::InternalPushArgument(UObject* Value)
 {
-	fastcall::push(JavascriptContext->ExportObject(Value));
+	PushArgument(JavascriptContext.Get(), JavascriptContext->ExportObject(Value));
+}
+
+void UJavascriptContext::InternalPushArgument(const FVector& Value)
+{
+	InternalPushArgument(FJavascriptStructArgument(TBaseStructure<FVector>::Get(), &Value));
+}
+
+void UJavascriptContext::InternalPushArgument(const FRotator& Value)
+{
+	InternalPushArgument(FJavascriptStructArgument(TBaseStructure<FRotator>::Get(), &Value));
+}
+
+void UJavascriptContext::InternalPushArgument(const FTransform& Value)
+{
+	InternalPushArgument(FJavascriptStructArgument(TBaseStructure<FTransform>::Get(), &Value));
+}
+
+void UJavascriptContext::InternalPushArgument(const TArray<float>& Value)
+{
+	auto isolate = JavascriptContext->isolate();
+	auto Bytes = Value.Num() * sizeof(float);
+	auto Buffer = ArrayBuffer::New(isolate, Bytes);
+	if (Bytes)
+	{
+		FMemory::Memcpy(Buffer->GetContents().Data(), Value.GetData(), Bytes);
+	}
+	PushArgument(JavascriptContext.Get(), Float32Array::New(Buffer, 0, Value.Num()));
+}
+
+void UJavascriptContext::InternalPushArgument(const FJavascriptStructArgument& Value)
+{
+	// Struct instance owns a copy of the value
+	PushArgument(JavascriptContext.Get(), JavascriptContext->Environment->ExportStructInstance(Value.Struct, (uint8*)Value.Data, FNoPropertyOwner()));
 }
 
 bool UJavascriptContext::InternalPopReturnValue(int32& Value)
 {
-	return !fastcall::retval.IsEmpty() && ((Value = fastcall::retval->Int32Value()), true);
+	auto retval = PopReturnValue(JavascriptContext.Get());
+	return !retval.IsEmpty() && ((Value = retval->Int32Value()), true);
 }
 
 bool UJavascriptContext::InternalPopReturnValue(float& Value)
 {
-	return !fastcall::retval.IsEmpty() && ((Value = fastcall::retval->NumberValue()), true);
+	auto retval = PopReturnValue(JavascriptContext.Get());
+	return !retval.IsEmpty() && ((Value = retval->NumberValue()), true);
 }
 
 bool UJavascriptContext::InternalPopReturnValue(bool& Value)
 {
-	return !fastcall::retval.IsEmpty() && ((Value = fastcall::retval->BooleanValue()), true);
+	auto retval = PopReturnValue(JavascriptContext.Get());
+	return !retval.IsEmpty() && ((Value = retval->BooleanValue()), true);
 }
 
 bool UJavascriptContext::InternalPopReturnValue(FString& Value)
 {
-	return !fastcall::retval.IsEmpty() && ((Value = (StringFromV8(fastcall::retval))), true);
+	auto retval = PopReturnValue(JavascriptContext.Get());
+	return !retval.IsEmpty() && ((Value = (StringFromV8(retval))), true);
 }
 
 bool UJavascriptContext::InternalPopReturnValue(UObject*& Value)
 {
-	return !fastcall::retval.IsEmpty() && ((Value = UObjectFromV8(fastcall::retval)), true);
+	auto retval = PopReturnValue(JavascriptContext.Get());
+	return !retval.IsEmpty() && ((Value = UObjectFromV8(retval)), true);
 }
 
 void UJavascriptContext::InternalBegin()
 {	
-	fastcall::enter(JavascriptContext->isolate());
-	fastcall::enter(JavascriptContext->context());
+	auto Context = JavascriptContext.Get();
+	auto isolate = Context->isolate();
+
+	// Frames are reused, so only the first call at each depth allocates
+	if (Context->CallDepth == Context->CallFrames.Num())
+	{
+		Context->CallFrames.Add(new FJavascriptCallFrame);
+	}
+
+	auto& Frame = Context->CallFrames[Context->CallDepth++];
+
+	isolate->Enter();
+	new(Frame.HandleScope.GetTypedPtr()) HandleScope(isolate);
+	Context->context()->Enter();
+
+	Frame.Argc = 0;
 }
 
 bool UJavascriptContext::InternalCall(UObject* Object, FName Name)
 {
-	auto context = JavascriptContext->context();
-	
-	auto func = JavascriptContext->GetProxyFunction(Object, *(Name.ToString()));
+	auto func = JavascriptContext->GetProxyFunction(Object, V8_KeywordString(JavascriptContext->isolate(), Name));
 	if (!func.IsEmpty() && func->IsFunction())
 	{
-		auto function = Local<Function>::Cast(func);
+		return CallFunction(JavascriptContext.Get(), Local<Function>::Cast(func));
+	}	
+	else
+	{
+		return false;
+	}	
+}
+
+bool UJavascriptContext::InternalCall(FJavascriptFunctionHandle& Handle)
+{
+	auto Context = JavascriptContext.Get();
+	auto isolate = Context->isolate();
+
+	// Holder has gone, there is nothing to resolve against
+	if (!Handle.Object.IsValid())
+	{
+		Handle.Reset();
+		return false;
+	}
 
-		TryCatch try_catch;
-		
-		fastcall::call(context->Global(), function);
+	// Resolved by another context, before proxies have changed, or not at all
+	if (Handle.Context.Pin().Get() != Context || Handle.Generation < Context->GetProxyGeneration(Handle.Object.Get()))
+	{
+		Handle.Reset();
 
-		if (try_catch.HasCaught())
+		auto func = Context->GetProxyFunction(Handle.Object.Get(), V8_KeywordString(isolate, Handle.Name));
+		if (func.IsEmpty() || !func->IsFunction())
 		{
-			FV8Exception::Report(try_catch);
 			return false;
 		}
-		else
-		{
-			return true;
-		}		
-	}	
-	else
+
+		Handle.Context = JavascriptContext;
+		Handle.Id = ++Context->LastFunctionHandleId;
+		Handle.Generation = Context->ProxyGeneration;
+		Context->FunctionHandles.Add(Handle.Id, UniquePersistent<Function>(isolate, Local<Function>::Cast(func)));
+	}
+
+	auto Cached = Context->FunctionHandles.Find(Handle.Id);
+	if (!Cached)
 	{
 		return false;
-	}	
+	}
+
+	return CallFunction(Context, Local<Function>::New(isolate, *Cached));
 }
 
 void UJavascriptContext::InternalEnd()
 {	
-	fastcall::reset();
-	fastcall::exit(JavascriptContext->context());
-	fastcall::exit(JavascriptContext->isolate());
-}
\ No newline at end of file
+	auto Context = JavascriptContext.Get();
+	auto isolate = Context->isolate();
+	auto& Frame = CurrentFrame(Context);
+
+	for (int32 Index = 0; Index < Frame.Argc; ++Index)
+	{
+		Frame.Argv[Index].Clear();
+	}
+	Frame.Argc = 0;
+	Frame.ReturnValue.Clear();
+
+	Context->context()->Exit();
+	Frame.HandleScope.GetTypedPtr()->~HandleScope();
+	isolate->Exit();
+
+	Context->CallDepth--;
+}
+
+void FJavascriptFunctionHandle::Reset()
+{
+	auto Pinned = Context.Pin();
+	if (Pinned.IsValid())
+	{
+		Pinned->FunctionHandles.Remove(Id);
+	}
+
+	Context.Reset();
+	Id = 0;
+}
@@ -1,6 +1,11 @@
 #include "V8PCH.h"
 #include <libplatform/libplatform.h>
 #include "JavascriptContext.h"
+#include "JavascriptSettings.h"
+
+#if WITH_EDITOR
+#include "ISettingsModule.h"
+#endif
 
 using namespace v8;
 
@@ -29,10 +34,28 @@ public:
 
 		auto v8flags = "--harmony --harmony-shipping --es-staging --expose-debug-as=v8debug --expose-gc --harmony_destructuring --harmony_simd --harmony_default_parameters ";
 		V8::SetFlagsFromString(v8flags, strlen(v8flags));
+
+#if WITH_EDITOR
+		if (auto SettingsModule = FModuleManager::GetModulePtr<ISettingsModule>("Settings"))
+		{
+			SettingsModule->RegisterSettings("Project", "Plugins", "UnrealJS",
+				NSLOCTEXT("UnrealJS", "SettingsName", "Unreal.js"),
+				NSLOCTEXT("UnrealJS", "SettingsDescription", "Configure the Javascript runtime"),
+				GetMutableDefault<UJavascriptSettings>()
+				);
+		}
+#endif
 	}
 
 	virtual void ShutdownModule() override
 	{		
+#if WITH_EDITOR
+		if (auto SettingsModule = FModuleManager::GetModulePtr<ISettingsModule>("Settings"))
+		{
+			SettingsModule->UnregisterSettings("Project", "Plugins", "UnrealJS");
+		}
+#endif
+
 		V8::Dispose();
 		V8::ShutdownPlatform();
 		delete platform_;
@@ -130,6 +153,11 @@ public:
 		}
 	}
 
+	virtual double MonotonicallyIncreasingTime() override
+	{
+		return platform_->MonotonicallyIncreasingTime();
+	}
+
 	virtual bool HasDebugContext() const
 	{
 		for (TObjectIterator<UJavascriptContext> It; It; ++It)
@@ -14,6 +14,8 @@
 
 DECLARE_LOG_CATEGORY_EXTERN(Javascript, Log, All);
 
+DECLARE_STATS_GROUP(TEXT("Javascript"), STATGROUP_Javascript, STATCAT_Advanced);
+
 struct IJavascriptDebugger
 {
 	virtual ~IJavascriptDebugger() {}
@@ -26,4 +26,7 @@ public:
 	virtual void GetContextIds(TArray<TSharedPtr<FString>>& OutContexts) = 0;
 	virtual void FillAutoCompletion(TSharedPtr<FString> TargetContext, TArray<FString>& OutArray, const TCHAR* Input) = 0;
 	virtual void Exec(TSharedPtr<FString> TargetContext, const TCHAR* Command) = 0;
+
+	/** Time base of V8 platform in seconds (for idle time deadlines) */
+	virtual double MonotonicallyIncreasingTime() = 0;
 };
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "JavascriptBundleCommandlet.generated.h"
+
+/**
+ * Packs scripts under the global script search paths into UJavascriptSettings::ScriptBundleFile
+ * Usage : UE4Editor.exe <Project> -run=JavascriptBundle [-NoCodeCache]
+ */
+UCLASS()
+class V8_API UJavascriptBundleCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+	virtual int32 Main(const FString& Params) override;
+};
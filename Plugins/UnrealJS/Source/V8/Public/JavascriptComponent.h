@@ -22,6 +22,13 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Javascript")
 	bool bActiveWithinEditor;
 
+	/** Seconds between ticks (0 : every frame) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Javascript", meta = (ClampMin = "0"))
+	float TickInterval;
+
+	UPROPERTY(transient)
+	UJavascriptIsolate* JavascriptIsolate;
+
 	UPROPERTY(transient)
 	UJavascriptContext* JavascriptContext;	
 
@@ -43,8 +50,12 @@ public:
 	virtual void OnRegister() override;
 	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
 	virtual void BeginDestroy() override;
+	virtual void RegisterComponentTickFunctions(bool bRegister) override;
 	// Begin UActorComponent interface.
 
+	/** Ticked by FJavascriptTickManager instead of its own tick function */
+	bool bTickBatched;
+
 	UFUNCTION(BlueprintCallable, Category = "Javascript")
 	void ForceGC();
 
@@ -56,14 +67,22 @@ public:
 
 	virtual void ProcessEvent(UFunction* Function, void* Parms) override;	
 
+private:
+	void ReleaseContext();
+
+	/** Time accumulated towards TickInterval when ticked by its own tick function */
+	float TimeSinceLastTick;
+
+public:
+
 	template <typename... Rest>
-	bool FastCall(Rest... rest)
+	bool FastCall(const Rest&... rest)
 	{
 		return JavascriptContext && JavascriptContext->FastCall(this, rest...);
 	}
 
 	template <typename... Rest>
-	bool FastCallWithReturn(Rest... rest)
+	bool FastCallWithReturn(const Rest&... rest)
 	{
 		return JavascriptContext && JavascriptContext->FastCallWithReturn(this, rest...);
 	}
@@ -5,13 +5,86 @@
 struct FJavascriptContext;
 class UJavascriptIsolate;
 
+/**
+ * ArrayBuffer or typed array passed from Javascript as a function parameter.
+ * Data points straight into the buffer (nothing is copied or externalized) and is only valid during the call.
+ */
+USTRUCT(BlueprintType)
+struct V8_API FJavascriptBuffer
+{
+	GENERATED_USTRUCT_BODY()
+
+	FJavascriptBuffer()
+		: Data(nullptr), Size(0)
+	{}
+
+	FJavascriptBuffer(void* InData, int32 InSize)
+		: Data(InData), Size(InSize)
+	{}
+
+	void* Data;
+	int32 Size;
+};
+
+/** Buffer bound by memory.bind in the current isolate (kept for compatibility, prefer FJavascriptBuffer parameters) */
 struct V8_API FArrayBufferAccessor
 {	
+	static FJavascriptBuffer GetBuffer();
 	static int32 GetSize();
 	static void* GetData();
 	static void Discard();
 };
 
+/** FastCall argument for any USTRUCT, passed to Javascript as a copy */
+struct FJavascriptStructArgument
+{
+	FJavascriptStructArgument(UScriptStruct* InStruct, const void* InData)
+		: Struct(InStruct), Data(InData)
+	{}
+
+	template <typename T>
+	static FJavascriptStructArgument Make(const T& Value)
+	{
+		return FJavascriptStructArgument(T::StaticStruct(), &Value);
+	}
+
+	UScriptStruct* Struct;
+	const void* Data;
+};
+
+/**
+ * Javascript function resolved once for (Object, Name) and cached by the context it was first called with.
+ * Keep one around for per-frame callbacks instead of passing a name to FastCall.
+ */
+struct V8_API FJavascriptFunctionHandle
+{
+	FJavascriptFunctionHandle(UObject* InObject, FName InName)
+		: Object(InObject), Name(InName), Id(0), Generation(0)
+	{}
+
+	~FJavascriptFunctionHandle()
+	{
+		Reset();
+	}
+
+	/** Forget resolved function, it will be looked up again on next call */
+	void Reset();
+
+	TWeakObjectPtr<UObject> Object;
+	FName Name;
+
+	// Cached function lives in Context->FunctionHandles[Id]
+	TWeakPtr<FJavascriptContext> Context;
+	int32 Id;
+
+	// FJavascriptContext::ProxyGeneration at the time of resolving (see GetProxyGeneration)
+	uint32 Generation;
+
+private:
+	FJavascriptFunctionHandle(const FJavascriptFunctionHandle&);
+	FJavascriptFunctionHandle& operator = (const FJavascriptFunctionHandle&);
+};
+
 UCLASS()
 class V8_API UJavascriptContext : public UObject
 {
@@ -44,6 +117,18 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Scripting|Javascript")
 	void RunFile(FString Filename);
 
+	/** Reads and compiles the file off the game thread, runs it on a later frame */
+	UFUNCTION(BlueprintCallable, Category = "Scripting|Javascript")
+	void RunFileAsync(FString Filename);
+
+	/** Loads modules in the background so that require() finds them ready (empty : UJavascriptSettings::PreloadModules) */
+	UFUNCTION(BlueprintCallable, Category = "Scripting|Javascript")
+	void Preload(TArray<FString> Modules);
+
+	/** Scripts still being loaded by RunFileAsync/Preload/requireAsync, a loading screen can wait for 0 */
+	UFUNCTION(BlueprintPure, Category = "Scripting|Javascript")
+	int32 GetNumPendingLoads() const;
+
 	UFUNCTION(BlueprintCallable, Category = "Scripting|Javascript")
 	FString RunScript(FString Script, bool bOutput = true);
 
@@ -72,6 +157,11 @@ public:
 	}
 	void InternalPushArgument(const TCHAR* Value);
 	void InternalPushArgument(UObject* Value);
+	void InternalPushArgument(const FVector& Value);
+	void InternalPushArgument(const FRotator& Value);
+	void InternalPushArgument(const FTransform& Value);
+	void InternalPushArgument(const TArray<float>& Value);
+	void InternalPushArgument(const FJavascriptStructArgument& Value);
 
 	bool InternalPopReturnValue(int32& Value);
 	bool InternalPopReturnValue(float& Value);
@@ -82,6 +172,11 @@ public:
 	void InternalBegin();
 	void InternalEnd();
 	bool InternalCall(UObject* Object, FName Name);
+	bool InternalCall(FJavascriptFunctionHandle& Handle);
+
+	void InternalPushArguments()
+	{
+	}
 
 	template <typename First>
 	void InternalPushArguments(const First& first)
@@ -90,14 +185,14 @@ public:
 	}
 
 	template <typename First, typename... Rest>
-	void InternalPushArguments(const First& first, Rest... rest)
+	void InternalPushArguments(const First& first, const Rest&... rest)
 	{
 		InternalPushArgument(first);
 		InternalPushArguments(rest...);
 	}
 
 	template <typename... Rest>
-	bool FastCall(UObject* Object, FName Name, Rest... rest)
+	bool FastCall(UObject* Object, FName Name, const Rest&... rest)
 	{
 		InternalBegin();
 		InternalPushArguments(rest...);
@@ -107,7 +202,7 @@ public:
 	}
 
 	template <typename Ret, typename... Rest>
-	bool FastCallWithReturn(UObject* Object, FName Name, Ret* ret, Rest... rest)
+	bool FastCallWithReturn(UObject* Object, FName Name, Ret* ret, const Rest&... rest)
 	{
 		InternalBegin();
 		InternalPushArguments(rest...);
@@ -122,4 +217,31 @@ public:
 		InternalEnd();
 		return successful;
 	}
+
+	template <typename... Rest>
+	bool FastCall(FJavascriptFunctionHandle& Handle, const Rest&... rest)
+	{
+		InternalBegin();
+		InternalPushArguments(rest...);
+		bool successful = InternalCall(Handle);
+		InternalEnd();
+		return successful;
+	}
+
+	template <typename Ret, typename... Rest>
+	bool FastCallWithReturn(FJavascriptFunctionHandle& Handle, Ret* ret, const Rest&... rest)
+	{
+		InternalBegin();
+		InternalPushArguments(rest...);
+		bool successful = InternalCall(Handle);
+		if (successful)
+		{
+			if (!InternalPopReturnValue(*ret))
+			{
+				successful = false;
+			}
+		}
+		InternalEnd();
+		return successful;
+	}
 };
\ No newline at end of file
@@ -4,14 +4,13 @@
 
 class FJavascriptDelegate;
 
+/** Dispatches a delegate to all Javascript listeners of FJavascriptDelegate */
 UCLASS()
 class V8_API UJavascriptDelegate : public UObject
 {
 	GENERATED_BODY()
 
 public:
-	int32 UniqueId;
-
 	FJavascriptDelegate* JavascriptDelegate;	
 
 	UFUNCTION(BlueprintCallable, Category = "Scripting|Javascript")
@@ -5,6 +5,71 @@
 class UJavascriptContext;
 class FJavascriptIsolate;
 
+/** Snapshot of an isolate's memory usage and wrapper bookkeeping */
+USTRUCT(BlueprintType)
+struct V8_API FJavascriptIsolateStats
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Scripting|Javascript")
+	int32 NumContexts;
+
+	/** UObjects exported to Javascript */
+	UPROPERTY(BlueprintReadOnly, Category = "Scripting|Javascript")
+	int32 NumObjectWrappers;
+
+	/** Struct instances held by Javascript */
+	UPROPERTY(BlueprintReadOnly, Category = "Scripting|Javascript")
+	int32 NumStructInstances;
+
+	/** Bytes owned by struct instances which don't point into an object (reported to V8 as external memory) */
+	UPROPERTY(BlueprintReadOnly, Category = "Scripting|Javascript")
+	int32 StructInstanceBytes;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Scripting|Javascript")
+	int32 NumArrayBuffers;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Scripting|Javascript")
+	int32 ArrayBufferBytes;
+
+	/** ArrayBuffer allocations served from the free lists */
+	UPROPERTY(BlueprintReadOnly, Category = "Scripting|Javascript")
+	int32 ArrayBufferPoolHits;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Scripting|Javascript")
+	int32 ArrayBufferPoolMisses;
+
+	/** Memory kept in the free lists */
+	UPROPERTY(BlueprintReadOnly, Category = "Scripting|Javascript")
+	int32 ArrayBufferPoolBytes;
+
+	/** Allocations per size class (16 << index bytes) */
+	UPROPERTY(BlueprintReadOnly, Category = "Scripting|Javascript")
+	TArray<int32> ArrayBufferPoolAllocs;
+
+	/** Frees per size class (16 << index bytes) */
+	UPROPERTY(BlueprintReadOnly, Category = "Scripting|Javascript")
+	TArray<int32> ArrayBufferPoolFrees;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Scripting|Javascript")
+	int32 NumClassTemplates;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Scripting|Javascript")
+	int32 NumStructTemplates;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Scripting|Javascript")
+	int32 UsedHeapSizeKB;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Scripting|Javascript")
+	int32 TotalHeapSizeKB;
+
+	FJavascriptIsolateStats()
+		: NumContexts(0), NumObjectWrappers(0), NumStructInstances(0), StructInstanceBytes(0), NumArrayBuffers(0), ArrayBufferBytes(0)
+		, ArrayBufferPoolHits(0), ArrayBufferPoolMisses(0), ArrayBufferPoolBytes(0)
+		, NumClassTemplates(0), NumStructTemplates(0), UsedHeapSizeKB(0), TotalHeapSizeKB(0)
+	{}
+};
+
 UCLASS()
 class V8_API UJavascriptIsolate : public UObject
 {
@@ -18,6 +83,18 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Scripting|Javascript")
 	UJavascriptContext* CreateContext();
 
+	/** Full V8 garbage collection (regular collections are scheduled in idle time, see UJavascriptSettings::GCPolicy) */
+	UFUNCTION(BlueprintCallable, Category = "Scripting|Javascript")
+	void ForceGC();
+
+	/** Memory usage of this isolate and all of its contexts (also available as 'Javascript.Stats' console command) */
+	UFUNCTION(BlueprintCallable, Category = "Scripting|Javascript")
+	FJavascriptIsolateStats GetStats();
+
+	/** Memory kept for reuse by small ArrayBuffers of this isolate (0 : no pooling), defaults to UJavascriptSettings::ArrayBufferPoolSizeKB */
+	UFUNCTION(BlueprintCallable, Category = "Scripting|Javascript")
+	void SetArrayBufferPoolSize(int32 SizeKB);
+
 	// Begin UObject interface.
 	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
 	// End UObject interface.
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "JavascriptSettings.generated.h"
+
+UENUM()
+namespace EJavascriptIsolateSharing
+{
+	enum Type
+	{
+		/** Every component has its own isolate */
+		PerComponent,
+		/** Components within the same world share isolates */
+		PerWorld,
+		/** All components share isolates */
+		Global
+	};
+}
+
+UENUM()
+namespace EJavascriptTypedArrayMode
+{
+	enum Type
+	{
+		/** Plain Javascript array, element by element */
+		Disabled,
+		/** Typed array holding a copy */
+		Copy,
+		/** Typed array over TArray's memory (frame-scoped, falls back to Copy for parameters) */
+		View
+	};
+}
+
+UENUM()
+namespace EJavascriptGCPolicy
+{
+	enum Type
+	{
+		/** Incremental work within the time left in the frame (TargetFrameTimeMs, at most MaxIdleTimeMs) */
+		Idle,
+		/** Incremental work for MaxIdleTimeMs every frame */
+		Budgeted,
+		/** Only V8's own allocation-triggered collections and explicit ForceGC */
+		Manual,
+		/** Full collection on every engine garbage collection (legacy behaviour) */
+		OnEngineGC
+	};
+}
+
+/** How a numeric TArray property is read */
+USTRUCT()
+struct FJavascriptTypedArrayProperty
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Owner class/struct and property name, ie. "Landscape.Heights" */
+	UPROPERTY(EditAnywhere, Category = "Javascript")
+	FString Property;
+
+	UPROPERTY(EditAnywhere, Category = "Javascript")
+	TEnumAsByte<EJavascriptTypedArrayMode::Type> Mode;
+};
+
+/**
+ * Project-wide settings for Unreal.js (Project Settings > Plugins > Unreal.js)
+ */
+UCLASS(config = Engine, defaultconfig)
+class V8_API UJavascriptSettings : public UObject
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+	/** Export UClass/UScriptStruct on first access from script instead of exporting all of them at isolate creation */
+	UPROPERTY(config, EditAnywhere, Category = "Isolate")
+	bool bLazyExport;
+
+	/** How UJavascriptComponents share isolates. Each component still has its own context. */
+	UPROPERTY(config, EditAnywhere, Category = "Isolate")
+	TEnumAsByte<EJavascriptIsolateSharing::Type> ComponentIsolateSharing;
+
+	/** Maximum number of isolates within a shared pool, components are spread over them */
+	UPROPERTY(config, EditAnywhere, Category = "Isolate", meta = (ClampMin = "1"))
+	int32 MaxIsolatesPerPool;
+
+	/** Tick UJavascriptComponents per world and tick group, with a single call into script per context (batched ticks ignore per-component tick prerequisites) */
+	UPROPERTY(config, EditAnywhere, Category = "Isolate")
+	bool bBatchComponentTicks;
+
+	/** When V8 garbage collection runs */
+	UPROPERTY(config, EditAnywhere, Category = "Garbage Collection")
+	TEnumAsByte<EJavascriptGCPolicy::Type> GCPolicy;
+
+	/** Frame budget, idle time is what is left of it at the end of a frame */
+	UPROPERTY(config, EditAnywhere, Category = "Garbage Collection", meta = (ClampMin = "0"))
+	float TargetFrameTimeMs;
+
+	/** Maximum time given to V8 per frame, shared by all isolates */
+	UPROPERTY(config, EditAnywhere, Category = "Garbage Collection", meta = (ClampMin = "0"))
+	float MaxIdleTimeMs;
+
+	/** Used heap size which triggers a full collection (0 : never) */
+	UPROPERTY(config, EditAnywhere, Category = "Garbage Collection", meta = (ClampMin = "0"))
+	int32 LowMemoryHeapSizeMB;
+
+	/** Delegates in batched mode (proxy.Batch(true)) deliver events collected during this time (0 : every frame) */
+	UPROPERTY(config, EditAnywhere, Category = "Delegates", meta = (ClampMin = "0"))
+	float DelegateBatchWindowMs;
+
+	/** Delegates in batched mode deliver right away when this many events have been collected */
+	UPROPERTY(config, EditAnywhere, Category = "Delegates", meta = (ClampMin = "1"))
+	int32 DelegateBatchMaxQueue;
+
+	/** Delegates checked per frame for destroyed objects (0 : all of them) */
+	UPROPERTY(config, EditAnywhere, Category = "Garbage Collection", meta = (ClampMin = "0"))
+	int32 DelegateSweepBatchSize;
+
+	/** How TArray<float/int32/uint8/uint16> properties are read by default */
+	UPROPERTY(config, EditAnywhere, Category = "Marshalling")
+	TEnumAsByte<EJavascriptTypedArrayMode::Type> TypedArrayMode;
+
+	/** Per-property override of TypedArrayMode */
+	UPROPERTY(config, EditAnywhere, Category = "Marshalling")
+	TArray<FJavascriptTypedArrayProperty> TypedArrayProperties;
+
+	/** TArray<UObject*>/TArray<FStruct> parameters and return values with at least this many elements are wrapped on access instead of being copied (0 : disabled; the wrapper is array-like, not an Array) */
+	UPROPERTY(config, EditAnywhere, Category = "Marshalling", meta = (ClampMin = "0"))
+	int32 LazyArrayThreshold;
+
+	/** Memory each isolate keeps in its ArrayBuffer free lists for blocks up to 4KB (0 : no pooling), see UJavascriptIsolate::SetArrayBufferPoolSize */
+	UPROPERTY(config, EditAnywhere, Category = "Memory", meta = (ClampMin = "0"))
+	int32 ArrayBufferPoolSizeKB;
+
+	/** Cache compiled code of script files under Saved/Javascript/CodeCache */
+	UPROPERTY(config, EditAnywhere, Category = "Compilation")
+	bool bCodeCache;
+
+	/** Modules loaded in the background by UJavascriptContext::Preload, e.g. during loading screens */
+	UPROPERTY(config, EditAnywhere, Category = "Compilation")
+	TArray<FString> PreloadModules;
+
+	/** Read scripts from the bundle built by JavascriptBundle commandlet in packaged builds (-ScriptBundle to use it in the editor) */
+	UPROPERTY(config, EditAnywhere, Category = "Script Bundle")
+	bool bUseScriptBundle;
+
+	/** Script bundle file (relative to game content directory) */
+	UPROPERTY(config, EditAnywhere, Category = "Script Bundle")
+	FString ScriptBundleFile;
+
+	/** Create isolates from the startup snapshot built by JavascriptSnapshot commandlet */
+	UPROPERTY(config, EditAnywhere, Category = "Snapshot")
+	bool bUseSnapshot;
+
+	/** Snapshot file (relative to game content directory) */
+	UPROPERTY(config, EditAnywhere, Category = "Snapshot")
+	FString SnapshotFile;
+
+	/** Scripts to evaluate as RunFile() into the snapshot. They should not touch any UObject. */
+	UPROPERTY(config, EditAnywhere, Category = "Snapshot")
+	TArray<FString> SnapshotScripts;
+
+	/** Modules to compile into the snapshot. Each context runs them on first require(), as it does for modules from file. */
+	UPROPERTY(config, EditAnywhere, Category = "Snapshot")
+	TArray<FString> SnapshotModules;
+};
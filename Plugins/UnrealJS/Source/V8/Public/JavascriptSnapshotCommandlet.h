@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "JavascriptSnapshotCommandlet.generated.h"
+
+/**
+ * Builds V8 startup snapshot out of UJavascriptSettings::SnapshotScripts/SnapshotModules
+ * Usage : UE4Editor.exe <Project> -run=JavascriptSnapshot
+ */
+UCLASS()
+class V8_API UJavascriptSnapshotCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+	virtual int32 Main(const FString& Params) override;
+};
@@ -44,6 +44,12 @@ public class V8 : ModuleRules
             { 
                 "UnrealEd"
             });
+
+            PrivateIncludePathModuleNames.AddRange(new string[] 
+            { 
+                "Settings",
+                "HotReload"
+            });
         }
 
         bEnableExceptions = true;